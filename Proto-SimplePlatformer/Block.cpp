@@ -5,6 +5,7 @@ using namespace agp;
 Block::Block(Scene* scene, const RectF& rect, Sprite* sprite, CollidableObject* watched, int layer) :
 	KinematicObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
 	_compenetrable = false;
 	_watched = watched;
 }
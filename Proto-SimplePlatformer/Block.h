@@ -15,6 +15,10 @@ protected:
 
 public:
 
+	// type tag
+	typedef Block TypeTagged;
+	static constexpr TypeMask typeBit() { return TypeMask(1) << BLOCK_TYPE; }
+
 	Block(Scene* scene, const RectF& rect, Sprite* sprite, CollidableObject* watched, int layer = 0);
 
 	virtual void update(float dt) override;
@@ -0,0 +1,238 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "ChainObject.h"
+#include "GameScene.h"
+#include "collisionUtils.h"
+#include "RenderSnapshot.h"
+
+using namespace agp;
+
+// margin around the chain (a flat chain would have a degenerate rect)
+static const float CHAIN_MARGIN = 0.05f;
+
+// bounding rect of the chain points (+margin)
+static RectF chainRect(const std::vector<PointF>& points)
+{
+	PointF minP = points.empty() ? PointF() : points[0];
+	PointF maxP = minP;
+	for (auto& p : points)
+	{
+		minP.x = std::min(minP.x, p.x);
+		minP.y = std::min(minP.y, p.y);
+		maxP.x = std::max(maxP.x, p.x);
+		maxP.y = std::max(maxP.y, p.y);
+	}
+
+	return RectF(minP - PointF(CHAIN_MARGIN, CHAIN_MARGIN), maxP + PointF(CHAIN_MARGIN, CHAIN_MARGIN));
+}
+
+// inclusive rect overlap
+static bool overlaps(const RectF& a, const RectF& b)
+{
+	return
+		a.pos.x <= b.pos.x + b.size.x && b.pos.x <= a.pos.x + a.size.x &&
+		a.pos.y <= b.pos.y + b.size.y && b.pos.y <= a.pos.y + a.size.y;
+}
+
+ChainObject::ChainObject(Scene* scene, const std::vector<PointF>& points, int layer) :
+	StaticObject(scene, RotatedRectF(chainRect(points)), nullptr, layer)
+{
+	_typeMask |= typeBit();
+	_shaped = true;
+
+	buildIndex(points);
+}
+
+void ChainObject::buildIndex(const std::vector<PointF>& points)
+{
+	_segments.clear();
+	_blocks.clear();
+	_vertexNormals.clear();
+
+	for (int i = 0; i + 1 < int(points.size()); i++)
+	{
+		Segment seg;
+		seg.line = LineF(points[i] - _rect.pos, points[i + 1] - _rect.pos);
+		seg.bounds = seg.line.boundingRect(false);
+		seg.normal = (seg.line.end - seg.line.start).perp().norm();
+		_segments.push_back(seg);
+
+		if (i % BLOCK_SIZE == 0)
+			_blocks.push_back(seg.bounds);
+		else
+			_blocks.back() = _blocks.back().united(seg.bounds);
+	}
+
+	// vertex normals: averaged between adjacent segments (folded joints: next segment)
+	for (int v = 0; v < int(points.size()) && !_segments.empty(); v++)
+	{
+		Vec2Df prev = _segments[std::max(v - 1, 0)].normal;
+		Vec2Df next = _segments[std::min(v, int(_segments.size()) - 1)].normal;
+		Vec2Df sum = prev + next;
+		_vertexNormals.push_back(sum.mag2() > 1e-6f ? sum.norm() : next);
+	}
+}
+
+Vec2Df ChainObject::contactNormal(int v, const Vec2Df& normal, const Vec2Df& moverCenter, const Vec2Df& sweep) const
+{
+	// segment interior or chain ends: segment normal
+	if (v <= 0 || v >= int(_vertexNormals.size()) - 1)
+		return normal;
+
+	// adjacent segments normals on the mover side
+	Vec2Df vertexNormal = _vertexNormals[v];
+	float side = (moverCenter - (_segments[v].line.start + _rect.pos)).dot(vertexNormal) < 0 ? -1.0f : 1.0f;
+	Vec2Df a = _segments[v - 1].normal * side;
+	Vec2Df b = _segments[v].normal * side;
+	vertexNormal = vertexNormal * side;
+
+	// contact normal within the two normals: real corner
+	const float parallel = 1 - 1e-3f;
+	float ab = a.cross(b);
+	if (normal.dot(a) >= parallel || normal.dot(b) >= parallel ||
+		(ab != 0 && a.cross(normal) * ab > 0 && normal.cross(b) * ab > 0))
+		return normal;
+
+	// ghost edge: vertex normal, unless the mover is not moving against it
+	return vertexNormal.dot(sweep) < 0 ? vertexNormal : Vec2Df();
+}
+
+bool ChainObject::intersectsLine(const LineF& line, float& tNear)
+{
+	tNear = 2;
+	Vec2Df d = line.end - line.start;
+	RectF lineRect = LineF(line.start - _rect.pos, line.end - _rect.pos).boundingRect(false);
+	for (int b = 0; b < int(_blocks.size()); b++)
+	{
+		if (!overlaps(_blocks[b], lineRect))
+			continue;
+
+		int last = std::min((b + 1) * BLOCK_SIZE, int(_segments.size()));
+		for (int s = b * BLOCK_SIZE; s < last; s++)
+		{
+			const Segment& seg = _segments[s];
+			if (!overlaps(seg.bounds, lineRect))
+				continue;
+
+			// segment vs. segment (parametric): line.start + t * d = start + u * e
+			Vec2Df start = seg.line.start + _rect.pos;
+			Vec2Df e = seg.line.end - seg.line.start;
+			float denom = d.cross(e);
+			if (denom == 0)
+				continue;
+			float t = (start - line.start).cross(e) / denom;
+			float u = (start - line.start).cross(d) / denom;
+			if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+				tNear = std::min(tNear, t);
+		}
+	}
+
+	return tNear <= 1;
+}
+
+bool ChainObject::sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time)
+{
+	OrientedBox box = mover->colliderOBBAt(source);
+	RectF swept = source.united(source + sweep) - _rect.pos;
+	Vec2Df moverCenter = box.center;
+
+	time = inf<float>();
+	for (int b = 0; b < int(_blocks.size()); b++)
+	{
+		if (!overlaps(_blocks[b], swept))
+			continue;
+
+		int last = std::min((b + 1) * BLOCK_SIZE, int(_segments.size()));
+		for (int s = b * BLOCK_SIZE; s < last; s++)
+		{
+			if (!overlaps(_segments[s].bounds, swept))
+				continue;
+
+			// mover edges swept against the segment
+			// (segment endpoints hitting the edge: contact on a chain vertex)
+			LineF seg = segment(s);
+			for (int e = 0; e < 4; e++)
+			{
+				Vec2Df cp, cn;
+				float t;
+				int hitCase;
+				LineF edge(box.vertices[e], box.vertices[(e + 1) % 4]);
+				if (DynamicLineVsLine(edge, sweep, seg, cp, cn, t, hitCase) && t < time)
+				{
+					int vertex = hitCase == 2 ? s : (hitCase == 3 ? s + 1 : -1);
+					cn = contactNormal(vertex, cn, moverCenter, sweep);
+					if (cn.x || cn.y)
+					{
+						time = t;
+						normal = cn;
+					}
+				}
+			}
+		}
+	}
+
+	return time != inf<float>();
+}
+
+bool ChainObject::overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth)
+{
+	OrientedBox box = other->sceneColliderOBB();
+	RectF r = other->sceneCollider() - _rect.pos;
+
+	bool intersects = false;
+	for (int b = 0; b < int(_blocks.size()); b++)
+	{
+		if (!overlaps(_blocks[b], r))
+			continue;
+
+		int last = std::min((b + 1) * BLOCK_SIZE, int(_segments.size()));
+		for (int s = b * BLOCK_SIZE; s < last; s++)
+		{
+			Vec2Df segAxis;
+			float segDepth;
+			if (overlaps(_segments[s].bounds, r) &&
+				checkCollisionSAT(box, OrientedBox(segment(s)), segAxis, segDepth) &&
+				(!intersects || segDepth > depth))
+			{
+				axis = segAxis;
+				depth = segDepth;
+				intersects = true;
+			}
+		}
+	}
+
+	return intersects;
+}
+
+void ChainObject::draw(SDL_Renderer* renderer, Transform camera)
+{
+	MovableObject::draw(renderer, camera);
+
+	if (_gameScene && _gameScene->collidersVisible())
+	{
+		SDL_SetRenderDrawColor(renderer, _colliderColor.r, _colliderColor.g, _colliderColor.b, _colliderColor.a);
+		for (int s = 0; s < segments(); s++)
+		{
+			LineF seg = segment(s);
+			PointF a = camera(seg.start);
+			PointF b = camera(seg.end);
+			SDL_RenderDrawLineF(renderer, a.x, a.y, b.x, b.y);
+		}
+	}
+}
+
+void ChainObject::snapshot(RenderSnapshot& snapshot)
+{
+	MovableObject::snapshot(snapshot);
+
+	if (_gameScene && _gameScene->collidersVisible())
+		for (int s = 0; s < segments(); s++)
+			snapshot.addLine(segment(s), _colliderColor, Vec2Df());
+}
@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "StaticObject.h"
+
+namespace agp
+{
+	class ChainObject;
+}
+
+// ChainObject class
+// - static collider made of a polyline (e.g. hand-drawn ground),
+//   a single scene object for the whole chain
+// - segments are indexed in blocks of consecutive segments, so that
+//   only segments near the mover are tested
+// - movers collide with their collider edges swept against the segments
+// - contacts on interior vertices use the vertex normal (smoothed between
+//   adjacent segments) unless the contact normal is within the two segments
+//   normals: movers slide across joints (no ghost edges)
+class agp::ChainObject : public StaticObject
+{
+	protected:
+
+		struct Segment
+		{
+			LineF line;			// in object coordinates
+			RectF bounds;		// in object coordinates
+			Vec2Df normal;		// unit normal (left side of the chain direction)
+		};
+
+		static const int BLOCK_SIZE = 8;		// segments per index block
+
+		std::vector<Segment> _segments;
+		std::vector<RectF> _blocks;				// bounds of BLOCK_SIZE consecutive segments
+		std::vector<Vec2Df> _vertexNormals;		// per vertex (interior: smoothed)
+
+		// helper functions
+		void buildIndex(const std::vector<PointF>& points);
+		Vec2Df contactNormal(int vertex, const Vec2Df& normal, const Vec2Df& moverCenter, const Vec2Df& sweep) const;
+
+	public:
+
+		// type tag
+		typedef ChainObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << CHAIN_TYPE; }
+
+		ChainObject(Scene* scene, const std::vector<PointF>& points, int layer = 0);
+		virtual ~ChainObject() {}
+
+		// getters
+		int segments() const { return int(_segments.size()); }
+		LineF segment(int i) const { return LineF(_segments[i].line.start + _rect.pos, _segments[i].line.end + _rect.pos); }
+
+		// overrides geometric queries (+segments)
+		virtual bool intersectsLine(const LineF& line, float& tNear) override;
+
+		// implements exact collision tests (+segments)
+		virtual bool sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time) override;
+		virtual bool overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth) override;
+
+		// extends rendering (+segments)
+		virtual void draw(SDL_Renderer* renderer, Transform camera) override;
+		virtual void snapshot(RenderSnapshot& snapshot) override;
+
+		virtual std::string name() override {
+			return strprintf("ChainObject[%d]", _id);
+		}
+};
@@ -13,15 +13,24 @@
 #include <algorithm>
 #include "timeUtils.h"
 #include "collisionUtils.h"
+#include "sdlUtils.h"
 #include "GameScene.h"
+#include "RenderSnapshot.h"
 
 using namespace agp;
 
 CollidableObject::CollidableObject(Scene* scene, const RotatedRectF& rect, Sprite* sprite, int layer) :
-	MovableObject(scene, rect.toRect(), sprite, layer)
+	MovableObject(scene, rect.angle ? rect.boundingRect() : rect.toRect(), sprite, layer)
 {
-	// default collider: object rect
+	_typeMask |= typeBit();
+	setCollisionFilter(TERRAIN_CATEGORY, ALL_CATEGORIES);
+
+	// default collider: object rect, or the rotated rect itself if any
 	_collider = { 0, 0, _rect.size.x, _rect.size.y };
+	_oriented = false;
+	_shaped = false;
+	if (rect.angle)
+		setOrientedCollider(RotatedRectF(rect.center - _rect.pos, rect.size, rect.angle, rect.yUp));
 
 	// default collision: non compenetration
 	_compenetrable = false;
@@ -29,11 +38,77 @@ CollidableObject::CollidableObject(Scene* scene, const RotatedRectF& rect, Sprit
 
 	// default collision system: Continous Collision Detection (CCD)
 	_CCD = true;
+
+	_gameScene = dynamic_cast<GameScene*>(scene);
+	_broadphasePos = _rect.pos;
+	_stepCandidatesEpoch = 0;
+	_contactsCached = false;
+}
+
+// exact rect comparisons (contact cache validation)
+static bool sameRect(const RectF& a, const RectF& b)
+{
+	return a.pos == b.pos && a.size == b.size;
+}
+static bool sameRect(const RectF& a, const RectsSoA& rects, int i)
+{
+	return a.pos.x == rects.x[i] && a.pos.y == rects.y[i] && a.size.x == rects.w[i] && a.size.y == rects.h[i];
+}
+static bool containsRect(const RectF& outer, const RectF& inner)
+{
+	return sameRect(outer.united(inner), outer);
 }
 
 void CollidableObject::defaultCollider()
 {
 	_collider = { 0, 0, _rect.size.x, _rect.size.y };
+	_oriented = false;
+	_shaped = false;
+}
+
+void CollidableObject::setOrientedCollider(const RotatedRectF& r)
+{
+	_colliderOBB = OrientedBox(r);
+	_collider = r.boundingRect();
+	_oriented = true;
+	_shaped = true;
+}
+
+// direction of a contact normal (oriented normals: dominant axis)
+Direction CollidableObject::normalDir(const Vec2Df& normal)
+{
+	Direction dir = normal2dir(normal);
+	if (dir == Direction::NONE && (normal.x || normal.y))
+		dir = std::abs(normal.x) > std::abs(normal.y) ?
+			normal2dir(Vec2Df(normal.x > 0 ? 1.0f : -1.0f, 0)) :
+			normal2dir(Vec2Df(0, normal.y > 0 ? 1.0f : -1.0f));
+	return dir;
+}
+
+bool CollidableObject::sweptContact(CollidableObject* obj, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time)
+{
+	return obj->sweptContactFrom(this, source, sweep, normal, time);
+}
+
+bool CollidableObject::sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time)
+{
+	if (_oriented || mover->_oriented)
+		return DynamicOBBVsOBB(mover->colliderOBBAt(source), sweep, sceneColliderOBB(), normal, time);
+
+	Vec2Df cp;
+	return DynamicRectVsRect(source, sweep, sceneCollider(), cp, normal, time);
+}
+
+bool CollidableObject::overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth)
+{
+	if (_oriented || other->_oriented)
+		return checkCollisionSAT(other->sceneColliderOBB(), sceneColliderOBB(), axis, depth);
+
+	Direction dir;
+	bool intersects = checkCollisionAABB(other->sceneCollider(), sceneCollider(), dir, depth);
+	if (intersects)
+		axis = dir2vec(dir);
+	return intersects;
 }
 
 void CollidableObject::update(float dt)
@@ -43,13 +118,14 @@ void CollidableObject::update(float dt)
 	if (_CCD)
 	{
 		// undo move since collision detection is based on CCD
-		_rect.pos -= _vel * dt;
+		// (exact pos restore, so that predicted contacts match)
+		_rect.pos = _moveStartPos;
 
 		// detect and resolve collisions by updating velocities
 		detectResolveCollisionsCCD(dt);
 
 		// move with updated velocity
-		_rect.pos += _vel * dt;
+		_rect.pos += vel() * dt;
 	}
 	else
 	{
@@ -58,55 +134,210 @@ void CollidableObject::update(float dt)
 	}
 }
 
+void CollidableObject::carriedBy(Object* platform, const Vec2Df& displacement)
+{
+	if (!_collidable || _static)
+	{
+		MovableObject::carriedBy(platform, displacement);
+		return;
+	}
+
+	// sweep only against what the carry moves the collider into
+	// (carrying platform excluded, same response of CCD resolution)
+	RectF source = sceneCollider();
+	Vec2Df move = displacement;
+	collisionCandidates(source.united(source + displacement));
+	for (auto item : _candidates)
+	{
+		CollidableObject* obj = static_cast<CollidableObject*>(item);	// candidates are collidable
+		Vec2Df cn;
+		float ct;
+		if (obj != this && obj != platform && obj->collidable() && !obj->compenetrable() && collidableWith(obj) &&
+			sweptContact(obj, source, move, cn, ct) && cn.dot(move) < 0)
+			move -= cn * cn.dot(move * (1 - ct));
+	}
+
+	_rect.pos += move;
+}
+
 RectF CollidableObject::sceneCollider() const
 {
 	return _collider + _rect.pos;
 }
 
-void CollidableObject::detectResolveCollisionsCCD(float dt)
+bool CollidableObject::broadphaseBounds(float dt, RectF& bounds)
 {
-	if (!_collidable)
+	if (!_collidable || _static)
+		return false;
+
+	// max displacement in one step: velocity is clipped to max velocity by physics,
+	// teleports (e.g. being carried) are bounded by the last displacement
+	PointF teleport = _rect.pos - _broadphasePos;
+	_broadphasePos = _rect.pos;
+	PointF margin(
+		std::max(std::abs(vel().x), xVelMax()) * dt + std::abs(teleport.x),
+		std::max(std::abs(vel().y), yVelMax()) * dt + std::abs(teleport.y));
+
+	// object rect is included as scene queries select objects by rect
+	RectF r = sceneCollider().united(_rect);
+	bounds = RectF(r.pos - margin, r.pos + r.size + margin, r.yUp);
+
+	return true;
+}
+
+void CollidableObject::collisionCandidates(const RectF& rect)
+{
+	_candidates.clear();
+
+	// within the reach of the prediction of this step: no queries
+	// (e.g. velocity changed by game logic after the prediction)
+	if (_gameScene && _stepCandidatesEpoch == _gameScene->queryEpoch() && containsRect(_stepReach, rect))
+		_gameScene->candidatesWithin(this, rect, _stepCandidates, _candidates, CollidableObject::typeBit());
+	else if (_gameScene)
+		_gameScene->collisionCandidates(this, rect, _candidates, CollidableObject::typeBit());
+	else
+	{
+		_scene->objects(rect, _candidates, Scene::QueryFilter::ofMask(CollidableObject::typeBit()));
+		auto last = std::remove_if(_candidates.begin(), _candidates.end(),
+			[this](Object* obj) { return !(obj->collisionCategory() & _collisionMask); });
+		_candidates.erase(last, _candidates.end());
+	}
+}
+
+bool CollidableObject::firstContact(CollidableObject* obj)
+{
+	return !_gameScene || _gameScene->firstContact(this, obj);
+}
+
+void CollidableObject::predictContacts(float dt)
+{
+	if (!_CCD || !_collidable)
 		return;
 
+	// candidates for any sweep of the step (velocity within max velocity,
+	// as in the broadphase bounds), reused if the prediction misses
+	Vec2Df sweep = predictedVel(dt) * dt;
+	PointF reach(
+		std::max(std::abs(sweep.x), xVelMax() * dt),
+		std::max(std::abs(sweep.y), yVelMax() * dt));
+	RectF r = sceneCollider();
+	_stepReach = RectF(r.pos - reach, r.pos + r.size + reach, r.yUp);
+	_stepCandidates.clear();
+	_stepCandidatesEpoch = _gameScene && _gameScene->stepCandidates(this, _stepReach, _stepCandidates, CollidableObject::typeBit()) ?
+		_gameScene->queryEpoch() : 0;
+
+	detectContactsCCD(sweep);
+}
+
+void CollidableObject::detectContactsCCD(const Vec2Df& sweep)
+{
 	// NARROW collision detection
-	// simulate next iteration pos to get objects within united bounding rect
-	PointF curPos = _rect.pos;
+	// objects within the united bounding rect of current and next iteration pos
+	// (next pos computed as in update, without moving: may run concurrently)
 	RectF curRect = sceneCollider();
-	_rect.pos += _vel * dt;
-	std::list<CollidableObject*> likely_collisions;
-	std::list<Object*> items_in_rect = _scene->objects(sceneCollider().united(curRect));
-	for (auto item : items_in_rect)
+	_likelyCollisions.clear();
+	collisionCandidates((_collider + (_rect.pos + sweep)).united(curRect));
+	for (auto item : _candidates)
 	{
-		CollidableObject* obj = item->to<CollidableObject*>();
-		if (obj && obj != this && obj->collidable() && collidableWith(obj))
-			likely_collisions.push_back(obj);
+		CollidableObject* obj = static_cast<CollidableObject*>(item);	// candidates are collidable
+		if (obj != this && obj->collidable() && collidableWith(obj))
+			_likelyCollisions.push_back(obj);
 	}
-	_rect.pos = curPos;	// restore current pos
 
 	// sort collisions in ascending order of contact time
-	Vec2Df cp, cn;
-	float ct = 0, min_t = INFINITY;
-	std::vector<std::pair<CollidableObject*, float>> sortedByContactTime;
-	for (auto& obj : likely_collisions)
-		if (DynamicRectVsRect(sceneCollider(), vel() * dt, obj->sceneCollider(), cp, cn, ct))
-			sortedByContactTime.push_back({ obj, ct });
-	std::sort(sortedByContactTime.begin(), sortedByContactTime.end(),
-		[this](const std::pair<CollidableObject*, float>& a, const std::pair<CollidableObject*, float>& b)
+	// (swept test of all likely collisions in a single batch,
+	// skipped if nothing changed since the previous step or prediction)
+	if (!contactsCacheHit(curRect, sweep))
+	{
+		_sweptTargets.clear();
+		for (auto& obj : _likelyCollisions)
+			_sweptTargets.push_back(obj->sceneCollider());
+		_contacts.clear();
+		DynamicRectVsRects(curRect, sweep, _sweptTargets, _sweptContacts);
+		for (int i = 0; i < _sweptTargets.size(); i++)
 		{
-			// if contact time is the same, give priority to nearest object
-			return a.second != b.second ? a.second < b.second : distance(a.first) < distance(b.first);
-		});
+			// oriented colliders: swept SAT instead of the AABB batch result
+			CollidableObject* obj = _likelyCollisions[i];
+			Vec2Df normal(_sweptContacts.nx[i], _sweptContacts.ny[i]);
+			float time = _sweptContacts.time[i];
+			bool hit = (_shaped || obj->_shaped) ?
+				sweptContact(obj, curRect, sweep, normal, time) : _sweptContacts.hit[i] != 0;
+			if (hit)
+			{
+				Vec2Df centerDist = curRect.center() - obj->sceneCollider().center();
+				_contacts.push_back({ obj, i, time, normal, centerDist.mag2() });
+			}
+		}
+		std::sort(_contacts.begin(), _contacts.end(),
+			[](const Contact& a, const Contact& b)
+			{
+				// if contact time is the same, give priority to nearest object
+				return a.time != b.time ? a.time < b.time : a.dist2 < b.dist2;
+			});
+
+		_cachedSource = curRect;
+		_cachedSweep = sweep;
+		_cachedTargets = _likelyCollisions;
+		_contactsCached = true;
+	}
+}
+
+void CollidableObject::detectResolveCollisionsCCD(float dt)
+{
+	if (!_collidable)
+		return;
+
+	RectF curRect = sceneCollider();
+	Vec2Df sweep = vel() * dt;
+	detectContactsCCD(sweep);
 
 	// solve the collisions in correct order 
-	for (auto obj : sortedByContactTime)
-		if (DynamicRectVsRect(sceneCollider(), vel() * dt, obj.first->sceneCollider(), cp, cn, ct))
+	// (cached contact is valid until velocity, collider or target change)
+	Vec2Df cn;
+	float ct = 0;
+	for (auto& contact : _contacts)
+	{
+		RectF source = sceneCollider();
+		RectF target = contact.obj->sceneCollider();
+		bool hit;
+		if (vel() * dt == sweep && sameRect(source, curRect) && sameRect(target, _sweptTargets, contact.target))
+		{
+			hit = true;
+			cn = contact.normal;
+			ct = contact.time;
+		}
+		else
+			hit = sweptContact(contact.obj, source, vel() * dt, cn, ct);
+
+		// shaped targets (chains, tiles) may be hit again after the response (e.g. corners)
+		for (int pass = 0; hit; pass++)
 		{
-			if (!obj.first->compenetrable())
-				velAdd(-cn * cn.dot(_vel * (1 - ct)));
+			if (!contact.obj->compenetrable())
+				velAdd(-cn * cn.dot(vel() * (1 - ct)));
 
-			obj.first->collision(this, normal2dir(cn));
-			collision(obj.first, inverse(normal2dir(cn)));
+			if (firstContact(contact.obj))
+			{
+				contact.obj->collision(this, normalDir(cn));
+				collision(contact.obj, inverse(normalDir(cn)));
+			}
+
+			hit = pass == 0 && contact.obj->_shaped && !contact.obj->compenetrable() &&
+				sweptContact(contact.obj, source, vel() * dt, cn, ct);
 		}
+	}
+}
+
+bool CollidableObject::contactsCacheHit(const RectF& source, const Vec2Df& sweep)
+{
+	if (!_contactsCached || !(sweep == _cachedSweep) || !sameRect(source, _cachedSource) ||
+		_likelyCollisions != _cachedTargets)
+		return false;
+
+	for (int i = 0; i < _sweptTargets.size(); i++)
+		if (!sameRect(_likelyCollisions[i]->sceneCollider(), _sweptTargets, i))
+			return false;
+
+	return true;
 }
 
 void CollidableObject::detectCollisions()
@@ -118,21 +349,25 @@ void CollidableObject::detectCollisions()
 	_collisionAxes.clear();
 	_collisionDepths.clear();
 
-	auto objectsInRect = _scene->objects(sceneCollider());
-	for (auto& obj : objectsInRect)
+	collisionCandidates(sceneCollider());
+	for (auto& obj : _candidates)
 	{
-		CollidableObject* collObj = obj->to<CollidableObject*>();
-		if (collObj && collObj != this && collObj->collidable() && collidableWith(collObj))
+		CollidableObject* collObj = static_cast<CollidableObject*>(obj);	// candidates are collidable
+		if (collObj != this && collObj->collidable() && collidableWith(collObj))
 		{
-			Direction axis;
+			Vec2Df axisVec;
 			float depth;
-			if (checkCollisionAABB(sceneCollider(), collObj->sceneCollider(), axis, depth))
+			if (collObj->overlapFrom(this, axisVec, depth))
 			{
+				Direction axis = normalDir(axisVec);
 				_collisions.push_back(collObj);
-				_collisionAxes.push_back(dir2vec(axis));
+				_collisionAxes.push_back(axisVec);
 				_collisionDepths.push_back(depth);
-				collision(collObj, axis);
-				collObj->collision(this, inverse(axis));
+				if (firstContact(collObj))
+				{
+					collision(collObj, axis);
+					collObj->collision(this, inverse(axis));
+				}
 			}
 		}
 	}
@@ -142,13 +377,40 @@ void CollidableObject::draw(SDL_Renderer* renderer, Transform camera)
 {
 	MovableObject::draw(renderer, camera);
 
-	GameScene* gameScene = dynamic_cast<GameScene*>(_scene);
-	if (gameScene && gameScene->collidersVisible())
+	if (_gameScene && _gameScene->collidersVisible())
 	{
-		auto vertices = sceneCollider().vertices();
-		SDL_FRect drawRect = RectF(camera(vertices[0]), camera(vertices[2])).toSDLf();
-		SDL_SetRenderDrawColor(renderer, _colliderColor.r, _colliderColor.g, _colliderColor.b, _colliderColor.a);
-		SDL_RenderDrawRectF(renderer, &drawRect);
+		if (_oriented)
+		{
+			OrientedBox obb = sceneColliderOBB();
+			DrawOBB(renderer, { camera(obb.vertices[0]), camera(obb.vertices[1]), camera(obb.vertices[2]), camera(obb.vertices[3]) }, _colliderColor);
+		}
+		else
+		{
+			auto vertices = sceneCollider().vertices();
+			SDL_FRect drawRect = RectF(camera(vertices[0]), camera(vertices[2])).toSDLf();
+			SDL_SetRenderDrawColor(renderer, _colliderColor.r, _colliderColor.g, _colliderColor.b, _colliderColor.a);
+			SDL_RenderDrawRectF(renderer, &drawRect);
+		}
+	}
+}
+
+void CollidableObject::snapshot(RenderSnapshot& snapshot)
+{
+	MovableObject::snapshot(snapshot);
+
+	if (_gameScene && _gameScene->collidersVisible())
+	{
+		Vec2Df step = _rect.pos - _prevPos;
+		if (_oriented)
+		{
+			OrientedBox obb = sceneColliderOBB();
+			snapshot.addPolygon({ obb.vertices[0], obb.vertices[1], obb.vertices[2], obb.vertices[3] }, _colliderColor, step);
+		}
+		else
+		{
+			auto vertices = sceneCollider().vertices();
+			snapshot.addRect(RectF(vertices[0], vertices[2]), _colliderColor, step);
+		}
 	}
 }
 
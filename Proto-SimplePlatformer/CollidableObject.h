@@ -9,14 +9,16 @@
 
 #pragma once
 #include "MovableObject.h"
+#include "collisionUtils.h"
 
 namespace agp
 {
 	class CollidableObject;
+	class GameScene;
 }
 
 // CollidableObject class.
-// - defines a collider (default: object rect)
+// - defines a collider (default: object rect), optionally oriented (OBB)
 // - implements collision detection and resolution
 // - defines logic collision (see collision method)
 class agp::CollidableObject : public MovableObject
@@ -24,7 +26,10 @@ class agp::CollidableObject : public MovableObject
 	protected:
 
 		// collisions
-		RectF _collider;			// in object coordinates
+		RectF _collider;			// in object coordinates (oriented collider: its bounding rect)
+		bool _oriented;				// if true, collides as _colliderOBB (SAT)
+		bool _shaped;				// if true, collider is not its bounding rect (oriented, chain, ...)
+		OrientedBox _colliderOBB;	// in object coordinates (cached vertices and axes)
 		bool _collidable;
 		bool _compenetrable;
 		const Color _colliderColor = { 255, 255, 0, 255 };
@@ -33,7 +38,46 @@ class agp::CollidableObject : public MovableObject
 		std::vector<Vec2Df> _collisionAxes;
 		std::vector<float> _collisionDepths;
 
+		// broadphase
+		GameScene* _gameScene;				// scene, if a GameScene (cast once: hot paths)
+		PointF _broadphasePos;				// pos at previous broadphase
+		std::vector<Object*> _candidates;	// reused by collision detection
+		std::vector<Object*> _stepCandidates;	// candidates superset within _stepReach (prediction)
+		RectF _stepReach;					// collider reach in the step (any velocity within max)
+		unsigned int _stepCandidatesEpoch;	// scene query epoch of _stepCandidates (0 = none)
+		std::vector<CollidableObject*> _likelyCollisions;	// reused by CCD
+		RectsSoA _sweptTargets;				// reused by CCD (batch swept test)
+		SweptContactsSoA _sweptContacts;	// reused by CCD (batch swept test)
+
+		// CCD contact cache
+		// - contacts are detected once and reused during resolution until velocity changes
+		// - sorted contacts are kept across steps and reused while the swept collider
+		//   and its likely collisions do not change (e.g. resting contacts)
+		struct Contact
+		{
+			CollidableObject* obj;
+			int target;			// index in _sweptTargets
+			float time;			// contact time along the sweep
+			Vec2Df normal;		// contact normal
+			float dist2;		// squared distance between colliders centers (sort key)
+		};
+		std::vector<Contact> _contacts;		// sorted by time, then distance
+		bool _contactsCached;				// whether the fields below are valid
+		RectF _cachedSource;				// swept collider of the cached contacts
+		Vec2Df _cachedSweep;				// sweep displacement of the cached contacts
+		std::vector<CollidableObject*> _cachedTargets;	// likely collisions of the cached contacts
+		bool contactsCacheHit(const RectF& source, const Vec2Df& sweep);
+
+		// collision candidates within the given scene rect
+		virtual void collisionCandidates(const RectF& rect);
+
+		// whether logic collision with obj has yet to be notified in this step
+		bool firstContact(CollidableObject* obj);
+
 		// CCD collision detection/resolution
+		// - detection: likely collisions and sorted contacts (cached) along sweep,
+		//   reads the scene only
+		virtual void detectContactsCCD(const Vec2Df& sweep);
 		virtual void detectResolveCollisionsCCD(float dt);
 
 		// AABB intersection-based collision detection and resolution
@@ -43,24 +87,59 @@ class agp::CollidableObject : public MovableObject
 		// set collider to default (whole rect)
 		void defaultCollider();
 
+		// swept test against obj (see sweptContactFrom)
+		bool sweptContact(CollidableObject* obj, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time);
+
+		// exact collision tests of another object against this one, for shaped colliders
+		// - swept: mover's collider at source moving by sweep, normal points to the mover
+		// - overlap: axis goes from other to this
+		// default: AABB, or OBB vs. OBB if any of the two is oriented
+		virtual bool sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time);
+		virtual bool overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth);
+
 	public:
 
+		// type tag
+		typedef CollidableObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << COLLIDABLE_TYPE; }
+
 		CollidableObject(Scene* scene, const RotatedRectF& rect, Sprite* sprite, int layer = 0);
 		virtual ~CollidableObject() {}
 
 		// getters/setters
 		const RectF& collider() const { return _collider; }
 		RectF sceneCollider() const;
+		bool oriented() const { return _oriented; }
+		OrientedBox sceneColliderOBB() const { return colliderOBBAt(sceneCollider()); }
+		OrientedBox colliderOBBAt(const RectF& sceneRect) const { return _oriented ? _colliderOBB + (sceneRect.pos - _collider.pos) : OrientedBox(sceneRect); }
+		bool shaped() const { return _shaped; }
+
+		// oriented collider in object coordinates (e.g. slopes)
+		// NOTE: meant to be set once, contact caches only compare bounding rects
+		void setOrientedCollider(const RotatedRectF& r);
 		bool compenetrable() const { return _compenetrable; }
 		bool collidable() const { return _collidable; }
 
 		// extends game logic (+collisions)
 		virtual void update(float dt) override;
 
+		// implements collision prediction (+CCD contacts along the predicted
+		// velocity, reused by the update if nothing changed in the meantime)
+		virtual void predictContacts(float dt) override;
+
+		// extends platform carry (+re-sweep along the displacement)
+		virtual void carriedBy(Object* platform, const Vec2Df& displacement) override;
+
+		// implements broadphase bounds (collider + max displacement in one step)
+		virtual bool broadphaseBounds(float dt, RectF& bounds) override;
+
 		// extends rendering (+collider)
 		virtual void draw(SDL_Renderer* renderer, Transform camera) override;
+		virtual void snapshot(RenderSnapshot& snapshot) override;
 
 		// defines acceptable collisions (default: any)
+		// NOTE: for rare custom cases only, category/mask filtering is much
+		// cheaper as it happens before any narrowphase work (see setCollisionFilter)
 		virtual bool collidableWith(CollidableObject* obj) { return true; }
 
 		// defines logic collision, i.e. what to do when two objects collide
@@ -68,6 +147,9 @@ class agp::CollidableObject : public MovableObject
 		// returns true if logic collision is resolved, false otherwise
 		virtual bool collision(CollidableObject* with, Direction fromDir) { return true; }
 
+		// direction of a contact normal (oriented normals: dominant axis)
+		static Direction normalDir(const Vec2Df& normal);
+
 		// euclidean distance between colliders
 		virtual float distance(CollidableObject* obj) const;
 };
\ No newline at end of file
@@ -14,6 +14,8 @@ using namespace agp;
 DynamicObject::DynamicObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer) :
 	CollidableObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(DYNAMIC_CATEGORY, ALL_CATEGORIES);
 	// dynamic objects are compenetrable vs. each other by default
 	// (e.g. player vs. spanwable, collectibles vs. enemies, ...)
 	// compenetration does not need to be resolved in these cases
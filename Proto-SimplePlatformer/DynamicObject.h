@@ -26,6 +26,10 @@ class agp::DynamicObject : public CollidableObject
 
 	public:
 
+		// type tag
+		typedef DynamicObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << DYNAMIC_TYPE; }
+
 		DynamicObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer = 0);
 		virtual ~DynamicObject() {}
 
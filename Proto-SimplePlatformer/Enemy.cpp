@@ -8,6 +8,8 @@ using namespace agp;
 Enemy::Enemy(Scene* scene, const RectF& rect, Sprite* sprite, int layer)
 	: DynamicObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(ENEMY_CATEGORY, ALL_CATEGORIES);
 	_smashable = true;
 	_dying = false;
 	_facingDir = Direction::LEFT;
@@ -15,7 +17,7 @@ Enemy::Enemy(Scene* scene, const RectF& rect, Sprite* sprite, int layer)
 
 bool Enemy::collision(CollidableObject* with, Direction fromDir)
 {
-	Knight* knight = dynamic_cast<Knight*>(with);
+	Knight* knight = with->to<Knight*>();
 
 	if (knight)
 	{
@@ -33,8 +35,8 @@ bool Enemy::collision(CollidableObject* with, Direction fromDir)
 void Enemy::smash()
 {
 	_dying = true;
-	_yGravityForce = 25;
-	_vel.y = -8;
+	setGravity(25);
+	setVelY(-8);
 	_collidable = false;
 	_flip = SDL_FLIP_VERTICAL;
 	Audio::instance()->playSound("kick");
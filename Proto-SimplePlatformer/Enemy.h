@@ -27,6 +27,10 @@ class agp::Enemy : public DynamicObject
 
 	public:
 
+		// type tag
+		typedef Enemy TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << ENEMY_TYPE; }
+
 		Enemy(Scene* scene, const RectF& rect, Sprite* sprite, int layer = 0);
 
 		// actions
@@ -7,23 +7,28 @@ using namespace agp;
 Hammer::Hammer(Scene* scene, const PointF& pos, Enemy* thrower)
 	: Enemy(scene, RectF(pos.x, pos.y, 1, 1), SpriteFactory::instance()->get("hammer"))
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(ENEMY_CATEGORY, MARIO_CATEGORY);	// Mario only
 	_collider.adjust(0.2f, 0.2f, -0.2f, -0.2f);
 	_smashable = true;
 	_thrower = thrower;
 	_throwing = false;
-	_yGravityForce = 0;
-	_xFrictionForce = 0;
-	_xSkiddingForce = 0;
-	_xMoveForce = 1000;
-	_xVelMax = 4;
-	_xDir = Direction::NONE;
+	setGravity(0);
+	setFriction(0);
+	setSkidding(0);
+	setMoveForce(1000);
+	setXVelMax(4);
+	setXDir(Direction::NONE);
+
+	// projectiles are many and short-lived: integrated in batch by the scene
+	setBatchPhysics(true);
 
 	schedule("throwing_on", 0.5f, [this]()
 		{
 			_throwing = true;
-			_yGravityForce = 25;
+			setGravity(25);
 			velAdd(Vec2Df(0, -9));
-			_xDir = _thrower->facingDir();
+			setXDir(_thrower->facingDir());
 			_angularVelocity = 1000;
 		});
 }
@@ -34,9 +39,4 @@ void Hammer::update(float dt)
 
 	if (!_throwing)
 		_rect.pos = _thrower->rect().pos + PointF(2 / 16.0f, 0);
-}
-
-bool Hammer::collidableWith(CollidableObject* obj)
-{
-	return dynamic_cast<Mario*>(obj);
 }
\ No newline at end of file
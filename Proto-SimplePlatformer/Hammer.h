@@ -25,13 +25,14 @@ class agp::Hammer : public Enemy
 
 	public:
 
+		// type tag
+		typedef Hammer TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << HAMMER_TYPE; }
+
 		Hammer(Scene* scene, const PointF& pos, Enemy* thrower);
 
 		// extends game logic (+Hammer logic)
 		virtual void update(float dt) override;
 
-		// extends collision logic (+collision with Mario only)
-		virtual bool collidableWith(CollidableObject* obj) override;
-
 		virtual std::string name() override { return strprintf("Hammer[%d]", _id); }
 };
\ No newline at end of file
@@ -10,6 +10,7 @@ using namespace agp;
 HammerBrother::HammerBrother(Scene* scene, const PointF& pos)
 	: Enemy(scene, RectF(pos.x + 1 / 16.0f, pos.y - 1, 1, 2), nullptr)
 {
+	_typeMask |= typeBit();
 	_collider.adjust(0.1f, 0.4f, -0.1f, -1 / 16.0f);
 
 	_sprites["walk"] = SpriteFactory::instance()->get("hammer_brother_walk");
@@ -21,12 +22,12 @@ HammerBrother::HammerBrother(Scene* scene, const PointF& pos)
 	_chasing = false;
 
 	// default physics
-	_yGravityForce = 25;
-	_xMoveForce = 1000;
-	_xFrictionForce = 0;
-	_xSkiddingForce = 1000;
-	_xVelMax = 1;
-	_xDir = Direction::LEFT;
+	setGravity(25);
+	setMoveForce(1000);
+	setFriction(0);
+	setSkidding(1000);
+	setXVelMax(1);
+	setXDir(Direction::LEFT);
 	_halfRangeX = 0.7f;
 
 	// scripting (hammer spawn loop)
@@ -64,7 +65,7 @@ HammerBrother::HammerBrother(Scene* scene, const PointF& pos)
 	schedule("chasing", 15.0f + rand() % 10, [this]
 		{
 			_chasing = true;
-			_xVelMax *= 2;
+			setXVelMax(xVelMax() * 2);
 		});
 }
 
@@ -87,11 +88,11 @@ void HammerBrother::update(float dt)
 	
 	// horizontal movement
 	if (_chasing)
-		_xDir = _facingDir;
+		setXDir(_facingDir);
 	else if (_rect.center().x >= _pivot.x + _halfRangeX)
-		_xDir = Direction::LEFT;
+		setXDir(Direction::LEFT);
 	else if(_rect.center().x <= _pivot.x - _halfRangeX)
-		_xDir = Direction::RIGHT;
+		setXDir(Direction::RIGHT);
 
 	// animations
 	if(!_dying)
@@ -30,6 +30,10 @@ class agp::HammerBrother : public Enemy
 
 	public:
 
+		// type tag
+		typedef HammerBrother TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << HAMMERBROTHER_TYPE; }
+
 		HammerBrother(Scene* scene, const PointF& pos);
 
 		// extends game logic (+HammerBrother logic)
@@ -9,12 +9,16 @@
 
 #include "KinematicObject.h"
 #include "DynamicObject.h"
+#include "GameScene.h"
+#include <algorithm>
 
 using namespace agp;
 
 KinematicObject::KinematicObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer) :
 	CollidableObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(TERRAIN_CATEGORY, DYNAMIC_CATEGORIES);	// DynamicObject only
 	_compenetrable = false;
 }
 
@@ -22,25 +26,23 @@ void KinematicObject::update(float dt)
 {
 	CollidableObject::update(dt);
 
-	for (auto obj : _collidingItems)
+	for (auto& rider : _riders)
 	{
 		// object "on" the platform -> object moves along with platform
-		// WARNING: this teleport may cause collisions with other objects to be missed!
-		if (obj.second == Direction::UP)
-			obj.first->moveBy(_vel * dt);
-			// the fix below fixes the compenetration issue due to float precision
-			// but generates spurious state transitions to 'falling' states
-			//obj.first->moveBy(_vel * dt - Vec2Df(0, 0.001f * dt));
-
-		// object hits platform from the bottom -> object pos corrected along y 
-		else if (obj.second == Direction::DOWN)
-			obj.first->moveBy(Vec2Df(0, _vel.y * dt));
-
+		// object hits platform from the bottom -> object pos corrected along y
 		// object hits platform from one side -> object pos corrected along x
+		Vec2Df displacement =
+			rider.second == Direction::UP ? vel() * dt :
+			rider.second == Direction::DOWN ? Vec2Df(0, vel().y * dt) :
+			Vec2Df(vel().x * dt, 0);
+
+		// carried after all objects have moved (no missed collisions)
+		if (_gameScene)
+			_gameScene->addCarry(this, rider.first, displacement);
 		else
-			obj.first->moveBy(Vec2Df(_vel.x * dt, 0));
+			rider.first->moveBy(displacement);
 	}
-	_collidingItems.clear();
+	_riders.clear();
 }
 
 bool KinematicObject::collision(CollidableObject* with, Direction fromDir)
@@ -50,14 +52,14 @@ bool KinematicObject::collision(CollidableObject* with, Direction fromDir)
 	DynamicObject* dobj = with->to<DynamicObject*>();
 	if (dobj)
 	{
-		_collidingItems[dobj] = fromDir;
+		auto rider = std::find_if(_riders.begin(), _riders.end(),
+			[dobj](const std::pair<DynamicObject*, Direction>& r) { return r.first == dobj; });
+		if (rider != _riders.end())
+			rider->second = fromDir;
+		else
+			_riders.push_back({ dobj, fromDir });
 		return true;
 	}
 	else
 		return false;
-}
-
-bool KinematicObject::collidableWith(CollidableObject* obj)
-{
-	return obj->to<DynamicObject*>();
 }
\ No newline at end of file
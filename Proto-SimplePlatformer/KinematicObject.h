@@ -9,7 +9,7 @@
 
 #pragma once
 #include "CollidableObject.h"
-#include <map>
+#include <vector>
 
 namespace agp
 {
@@ -18,27 +18,30 @@ namespace agp
 }
 
 // KinematicObject class.
-// - captures colliding DynamicObjects and corrects their movement
+// - captures colliding DynamicObjects and carries them along at the end
+//   of the step (see GameScene::addCarry)
 class agp::KinematicObject : public CollidableObject
 {
 	protected:
 
-		std::map<DynamicObject*, Direction> _collidingItems;
+		// riders captured since the last update (flat list, reused)
+		std::vector<std::pair<DynamicObject*, Direction>> _riders;
 
 	public:
 
+		// type tag
+		typedef KinematicObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << KINEMATIC_TYPE; }
+
 		KinematicObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer = 0);
 		virtual ~KinematicObject() {}
 
-		// extends game logic (+moving colliding dynamic objects)
+		// extends game logic (+carrying colliding dynamic objects)
 		virtual void update(float dt) override;
 
 		// extends logic collision (+capturing colliding dynamic objects)
 		virtual bool collision(CollidableObject* with, Direction fromDir) override;
 
-		// accepts only collisions with DynamicObject
-		virtual bool collidableWith(CollidableObject* obj) override;
-
 		virtual std::string name() override {
 			return strprintf("KinematicObject[%d]", _id);
 		}
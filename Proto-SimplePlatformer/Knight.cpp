@@ -19,6 +19,8 @@ using namespace agp;
 Knight::Knight(Scene* scene, const PointF& pos)
 	: DynamicObject(scene, RectF(pos.x + 1 / 16.0f, pos.y, 2, 2), nullptr)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(KNIGHT_CATEGORY, ALL_CATEGORIES);
 	_collider.adjust(0.2f, 0, -0.2f, -1 / 16.0f);
 	_fit = false;
 	_walking = false;
@@ -47,9 +49,9 @@ void Knight::update(float dt)
 	// state logic
 	if (_jumping && grounded())
 		_jumping = false;
-	if (_vel.x != 0 && !_jumping)
-		_xLastNonZeroVel = _vel.x;
-	_walking = _vel.x != 0;
+	if (vel().x != 0 && !_jumping)
+		_xLastNonZeroVel = vel().x;
+	_walking = vel().x != 0;
 
 	// animations
 	if (_dying)
@@ -66,7 +68,7 @@ void Knight::update(float dt)
 		_sprite = _sprites["stand"];
 
 	// x-mirroring
-	if ((_vel.x < 0 && !_jumping) || _xLastNonZeroVel < 0)
+	if ((vel().x < 0 && !_jumping) || _xLastNonZeroVel < 0)
 		_flip = SDL_FLIP_HORIZONTAL;
 	else
 		_flip = SDL_FLIP_NONE;
@@ -89,16 +91,16 @@ void Knight::jump(bool on)
 	{
 		velAdd(Vec2Df(0, -_yJumpImpulse));
 
-		if (std::abs(_vel.x) < 9)
-			_yGravityForce = 25;
+		if (std::abs(vel().x) < 9)
+			setGravity(25);
 		else
-			_yGravityForce = 21;
+			setGravity(21);
 
 		_jumping = true;
 		Audio::instance()->playSound("jump-small");
 	}
 	else if (!on && midair() && !_dying)
-		_yGravityForce = 100;
+		setGravity(100);
 }
 
 void Knight::run(bool on)
@@ -108,13 +110,13 @@ void Knight::run(bool on)
 
 	if (on)
 	{
-		_xVelMax = 10;
-		_xMoveForce = 13;
+		setXVelMax(10);
+		setMoveForce(13);
 	}
 	else
 	{
-		_xVelMax = 6;
-		_xMoveForce = 8;
+		setXVelMax(6);
+		setMoveForce(8);
 	}
 }
 
@@ -139,16 +141,16 @@ void Knight::die()
 
 	_dying = true;
 	_collidable = false;
-	_yGravityForce = 0;
-	_vel = { 0,0 };
-	_xDir = Direction::NONE;
+	setGravity(0);
+	setVel({ 0,0 });
+	setXDir(Direction::NONE);
 	Audio::instance()->haltMusic();
 	Audio::instance()->playSound("death");
 	dynamic_cast<PlatformerGame*>(Game::instance())->freeze(true);
 
 	schedule("dying", 0.5f, [this]()
 		{
-			_yGravityForce = 25;
+			setGravity(25);
 			velAdd(Vec2Df(0, -_yJumpImpulse));
 			schedule("die", 3, [this]()
 				{
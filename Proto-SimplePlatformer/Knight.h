@@ -34,6 +34,10 @@ private:
 
 public:
 
+	// type tag
+	typedef Knight TypeTagged;
+	static constexpr TypeMask typeBit() { return TypeMask(1) << KNIGHT_TYPE; }
+
 	Knight(Scene* scene, const PointF& pos);
 
 	// getters/setters
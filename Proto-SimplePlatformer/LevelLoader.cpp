@@ -11,6 +11,8 @@
 #include "SpriteFactory.h"
 #include "RenderableObject.h"
 #include "StaticObject.h"
+#include "ChainObject.h"
+#include "TileLayer.h"
 #include "PlatformerGameScene.h"
 #include "Knight.h"
 #include "HammerBrother.h"
@@ -24,6 +26,16 @@
 
 using namespace agp;
 
+// solid materials of tile-based level bitmaps (Super Mario Bros. palette)
+static const std::vector<TileGrid::Material> solidMaterials =
+{
+	// ground, bricks, question/hard blocks and stairs (outlines included)
+	{ { Color(200, 76, 12), Color(252, 188, 176), Color(252, 152, 56), Color(0, 0, 0) }, 0.5f, 0 },
+
+	// pipes: both greens (bushes are light green only, hills dark green only)
+	{ { Color(128, 208, 16), Color(0, 168, 0) }, 0.5f, 0.15f }
+};
+
 LevelLoader::LevelLoader()
 {
 	// e.g. load level data from disk
@@ -82,15 +94,11 @@ void LevelLoader::loadJson(
 		else if (jObj.contains("multiline"))
 		{
 			std::vector<nlohmann::json> jsonPoints = jObj["multiline"].get<std::vector<nlohmann::json>>();
-			for (int i = 0; i < jsonPoints.size() - 1; i++)
-			{
-				float x1 = jsonPoints[i]["x"];
-				float y1 = jsonPoints[i]["y"];
-				float x2 = jsonPoints[i + 1]["x"];
-				float y2 = jsonPoints[i + 1]["y"];
-				LineF line(x1, y1, x2, y2);
-				new StaticObject(world, RotatedRectF(line, 0.1f, false), nullptr, 2);
-			}
+			std::vector<PointF> points;
+			for (auto& jPoint : jsonPoints)
+				points.push_back(PointF(jPoint["x"], jPoint["y"]));
+			if (points.size() >= 2)
+				new ChainObject(world, points, 2);
 		}
 	}
 
@@ -129,6 +137,21 @@ Scene* LevelLoader::load(const std::string& name)
 		world->addBackgroundScene(new OverlayScene(world, spriteLoader->get("trees2_bg"), { 0.6f, 1 }, true, { 32,32 }, {0,-2}));
 
 
+		return world;
+	}
+	else if (name == "1-1")
+	{
+		// tile-based level: terrain from the solid materials of the level bitmap (16 x 16 pixels tiles)
+		TileGrid tiles;
+		if (!tiles.loadBitmap(std::string(SOURCE_DIR) + "levels/1-1.png", 16, solidMaterials, { 0, 0 }, 1))
+			return nullptr;
+
+		PlatformerGameScene* world = new PlatformerGameScene(tiles.rect(), { 16,16 }, 1 / 100.0f);
+		new TileLayer(world, tiles, spriteLoader->get("level_1-1"));
+
+		Knight* player = new Knight(world, PointF(3, 10));
+		world->setPlayer(player);
+
 		return world;
 	}
 	else
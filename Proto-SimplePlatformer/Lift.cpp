@@ -5,6 +5,7 @@ using namespace agp;
 Lift::Lift(Scene* scene, const RectF& rect, Sprite* sprite, bool vertical, float range, int layer) :
 	KinematicObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
 	_compenetrable = false;
 	_vertical = vertical;
 	_r0 = (_vertical ? _rect.pos.y : _rect.pos.x) - range / 2.0f;
@@ -12,16 +13,16 @@ Lift::Lift(Scene* scene, const RectF& rect, Sprite* sprite, bool vertical, float
 
 	if (_vertical)
 	{
-		_yGravityForce = 3.f;
-		_yVelMax = 3;
-		_yVelMin = 0;
+		setGravity(3.f);
+		setYVelMax(3);
+		setYVelMin(0);
 	}
 	else
 	{
-		_yGravityForce = 0;
-		_xMoveForce = 3.f;
-		_xSkiddingForce = 3.f;
-		_xVelMax = 3;
+		setGravity(0);
+		setMoveForce(3.f);
+		setSkidding(3.f);
+		setXVelMax(3);
 		move(Direction::RIGHT);
 	}
 }
@@ -31,9 +32,9 @@ void Lift::update(float dt)
 	if (_vertical)
 	{
 		if (_rect.pos.y < _r0)
-			_yGravityForce = 3.f;
+			setGravity(3.f);
 		else if (_rect.pos.y > _r1)
-			_yGravityForce = -3.f;
+			setGravity(-3.f);
 	}
 	else
 	{
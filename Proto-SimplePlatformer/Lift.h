@@ -16,6 +16,10 @@ class agp::Lift : public KinematicObject
 
 	public:
 
+		// type tag
+		typedef Lift TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << LIFT_TYPE; }
+
 		Lift(Scene* scene, const RectF& rect, Sprite* sprite, bool vertical, float range, int layer = 0);
 
 		virtual void update(float dt) override;
@@ -20,6 +20,8 @@ using namespace agp;
 Mario::Mario(Scene* scene, const PointF& pos)
 	: DynamicObject(scene, RectF( pos.x + 1 / 16.0f, pos.y, 1, 1 ), nullptr)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(MARIO_CATEGORY, ALL_CATEGORIES);
 	_collider.adjust(0.2f, 0, -0.2f, -1/16.0f);
 
 	_walking = false;
@@ -51,10 +53,10 @@ void Mario::update(float dt)
 	// state logic
 	if (_jumping && grounded())
 		_jumping = false;
-	if (_vel.x != 0 && !_jumping)
-		_xLastNonZeroVel = _vel.x;
-	_walking = _vel.x != 0;
-	_running = std::abs(_vel.x) > 6;
+	if (vel().x != 0 && !_jumping)
+		_xLastNonZeroVel = vel().x;
+	_walking = vel().x != 0;
+	_running = std::abs(vel().x) > 6;
 
 	// animations
 	if(_dying)
@@ -73,7 +75,7 @@ void Mario::update(float dt)
 		_sprite = _sprites["stand"];
 
 	// x-mirroring
-	if ((_vel.x < 0 && !_jumping) || _xLastNonZeroVel < 0)
+	if ((vel().x < 0 && !_jumping) || _xLastNonZeroVel < 0)
 		_flip = SDL_FLIP_HORIZONTAL;
 	else
 		_flip = SDL_FLIP_NONE;
@@ -96,16 +98,16 @@ void Mario::jump(bool on)
 	{
 		velAdd(Vec2Df(0, -_yJumpImpulse));
 
-		if (std::abs(_vel.x) < 9)
-			_yGravityForce = 25;
+		if (std::abs(vel().x) < 9)
+			setGravity(25);
 		else
-			_yGravityForce = 21;
+			setGravity(21);
 
 		_jumping = true;
 		Audio::instance()->playSound("jump-small");
 	}
 	else if (!on && midair() && !_dying)
-		_yGravityForce = 100;
+		setGravity(100);
 }
 
 void Mario::run(bool on)
@@ -115,13 +117,13 @@ void Mario::run(bool on)
 
 	if (on)
 	{
-		_xVelMax = 10;
-		_xMoveForce = 13;
+		setXVelMax(10);
+		setMoveForce(13);
 	}
 	else
 	{
-		_xVelMax = 6;	
-		_xMoveForce = 8;
+		setXVelMax(6);	
+		setMoveForce(8);
 	}
 }
 
@@ -156,16 +158,16 @@ void Mario::die()
 
 	_dying = true;
 	_collidable = false;
-	_yGravityForce = 0;
-	_vel = { 0,0 };
-	_xDir = Direction::NONE;
+	setGravity(0);
+	setVel({ 0,0 });
+	setXDir(Direction::NONE);
 	Audio::instance()->haltMusic();
 	Audio::instance()->playSound("death");
 	dynamic_cast<PlatformerGame*>(Game::instance())->freeze(true);
 
 	schedule("dying", 0.5f, [this]()
 		{
-			_yGravityForce = 25;
+			setGravity(25);
 			velAdd(Vec2Df(0, -_yJumpImpulse));
 			schedule("die", 3, [this]()
 				{
@@ -37,6 +37,10 @@ class agp::Mario : public DynamicObject
 
 	public:
 
+		// type tag
+		typedef Mario TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << MARIO_TYPE; }
+
 		Mario(Scene* scene, const PointF& pos);
 
 		// getters/setters
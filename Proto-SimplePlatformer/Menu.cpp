@@ -24,6 +24,7 @@ MenuItem::MenuItem(Menu* container, int index, const std::string& text, std::fun
 			container->menuRect().size.x, 0.5f),
 		SpriteFactory::instance()->getText(' ' + text, { 0.5f, 0.5f }, 0, ' ', false), 1)
 {
+	_typeMask |= typeBit();
 	_container = container;
 	_index = index;
 	_text = text;
@@ -131,14 +132,14 @@ Menu* Menu::mainMenu()
 		nestedMenu->addItem("Commands", []() {printf("Commands pressed\n"); });
 		nestedMenu->addItem("Volume", []() {printf("Volume pressed\n"); });
 
-		SDL_RendererInfo info;
-		SDL_GetRendererInfo(Game::instance()->window()->renderer(), &info);
-		bool vsyncOn = info.flags & SDL_RENDERER_PRESENTVSYNC;
+		bool vsyncOn = Game::instance()->pacing() == Game::Pacing::VSYNC;
 		nestedMenu->addItem(std::string("VSYNC ") + (vsyncOn ? "on" : "off"), [nestedMenu]()
 			{
-				bool vsyncOn = nestedMenu->itemAt(2)->text() == "VSYNC on";
-				nestedMenu->itemAt(2)->setText(vsyncOn ? "VSYNC off" : "VSYNC on");
-				SDL_RenderSetVSync(Game::instance()->window()->renderer(), !vsyncOn);
+				// off: capped at the display refresh rate (no busy loop)
+				Game* game = Game::instance();
+				bool vsyncOn = game->pacing() == Game::Pacing::VSYNC;
+				game->setPacing(vsyncOn ? Game::Pacing::CAPPED : Game::Pacing::VSYNC, float(game->window()->refreshRate()));
+				nestedMenu->itemAt(2)->setText(game->pacing() == Game::Pacing::VSYNC ? "VSYNC on" : "VSYNC off");
 			});
 		Game::instance()->pushScene(nestedMenu);
 	});
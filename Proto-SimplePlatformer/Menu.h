@@ -10,6 +10,7 @@
 #pragma once
 #include "UIScene.h"
 #include "RenderableObject.h"
+#include "ObjectTypes.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -34,6 +35,10 @@ class agp::MenuItem : public RenderableObject
 
 	public:
 
+		// type tag
+		typedef MenuItem TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << MENUITEM_TYPE; }
+
 		MenuItem(Menu* container, int index, const std::string& text, std::function<void()> task);
 		virtual ~MenuItem() {};	
 
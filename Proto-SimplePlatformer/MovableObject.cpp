@@ -11,54 +11,75 @@
 
 using namespace agp;
 
+static int dirSign(Direction dir)
+{
+	return dir == Direction::RIGHT ? 1 : (dir == Direction::LEFT ? -1 : 0);
+}
+
 MovableObject::MovableObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer) :
 	RenderableObject(scene, rect, sprite, layer)
 {
+	_typeMask |= typeBit();
+	_batchPhysics = false;
+	_physicsStore = nullptr;
+
 	// default movement (stand)
 	_xDir = Direction::NONE;
 	_vel = { 0, 0 };
+	_prevVel = { 0, 0 };
+	_moveStartPos = _rect.pos;
 
 	defaultPhysics();
 }
 
 void MovableObject::defaultPhysics()
 {
-	_yGravityForce = 100;
+	setGravity(100);
 	_yJumpImpulse = 15;
-	_yVelMax = 15;
-	_yVelMin = 0.01f;
-	_xVelMax = 6;			// 10 in running mode
-	_xVelMin = 0.3f;
-	_xMoveForce = 8;		// 13 in running mode
-	_xFrictionForce = 11;
-	_xSkiddingForce = 23;
+	setYVelMax(15);
+	setYVelMin(0.01f);
+	setXVelMax(6);			// 10 in running mode
+	setXVelMin(0.3f);
+	setMoveForce(8);		// 13 in running mode
+	setFriction(11);
+	setSkidding(23);
 }
 
 void MovableObject::velClip(float vx, float vy)
 {
-	_vel.x = std::max(_vel.x, -vx);
-	_vel.x = std::min(_vel.x, vx);
-	_vel.y = std::max(_vel.y, -vy);
-	_vel.y = std::min(_vel.y, vy);
+	Vec2Df vel = this->vel();
+	vel.x = std::max(vel.x, -vx);
+	vel.x = std::min(vel.x, vx);
+	vel.y = std::max(vel.y, -vy);
+	vel.y = std::min(vel.y, vy);
+	setVel(vel);
 }
 
 void MovableObject::velAdd(Vec2Df amount)
 {
-	_vel += amount;
-
-	// max velocity clipping
-	velClip(_xVelMax, _yVelMax);
+	float& vx = state(&PhysicsStore::velX, _vel.x);
+	float& vy = state(&PhysicsStore::velY, _vel.y);
+	vx += amount.x;
+	vy += amount.y;
+
+	// max and min velocity clipping (min x only when not moving: allows skidding)
+	PhysicsStore::clip(vx, vy, dirSign(_xDir), xVelMax(), yVelMax(),
+		state(&PhysicsStore::velMinX, _xVelMin), state(&PhysicsStore::velMinY, _yVelMin));
+}
 
-	// min velocity clipping
-	if (_xDir == Direction::NONE && std::abs(_vel.x) < _xVelMin)
-		_vel.x = 0; // checking _xDir to allow skidding
-	if (std::abs(_vel.y) < _yVelMin)
-		_vel.y = 0;
+void MovableObject::setXDir(Direction dir)
+{
+	_xDir = dir;
+	if (_physicsStore)
+	{
+		_physicsStore->dirX[_physicsIndex] = dirSign(dir);
+		changed();
+	}
 }
 
 void MovableObject::move(Direction dir)
 {
-	_xDir = dir;
+	setXDir(dir);
 }
 
 void MovableObject::jump()
@@ -69,49 +90,102 @@ void MovableObject::jump()
 
 bool MovableObject::skidding() const
 {
-	return (_xDir == Direction::RIGHT && _vel.x < 0) ||
-		   (_xDir == Direction::LEFT  && _vel.x > 0);
+	Vec2Df vel = this->vel();
+	return (_xDir == Direction::RIGHT && vel.x < 0) ||
+		   (_xDir == Direction::LEFT  && vel.x > 0);
 }
 
 bool MovableObject::grounded() const
 {
-	return _vel.y == 0 && _prevVel.y > 0;
+	return vel().y == 0 && prevVel().y > 0;
 }
 
 bool MovableObject::falling() const
 {
-	return _vel.y > 0 && _prevVel.y <= 0;
+	return vel().y > 0 && prevVel().y <= 0;
 }
 
 bool MovableObject::midair() const
 {
-	return _vel.y != 0 || (_vel.y == 0 && _prevVel.y < 0);
+	float vy = vel().y;
+	return vy != 0 || (vy == 0 && prevVel().y < 0);
 }
 
 void MovableObject::update(float dt)
 {
 	RenderableObject::update(dt);
 
-	// velocity backup (useful to determine object state)
-	_prevVel = _vel;
-
 	// Semi-implicit Euler integration
 	// 1) update velocity (=apply accelerations = forces)
 	// 2) use updated velocity to update position
 
-	// apply gravity acceleration
-	velAdd(Vec2Df(0, _yGravityForce * dt));
-
-	// apply horizontal accelerations and decelerations
-	if (_xDir == Direction::RIGHT && _vel.x >= 0)
-		velAdd(Vec2Df(_xMoveForce * dt, 0));
-	else if (_xDir == Direction::LEFT && _vel.x <= 0)
-		velAdd(Vec2Df(-_xMoveForce * dt, 0));
-	else if (_xDir == Direction::NONE)
-		velAdd(Vec2Df(-_vel.versX() * _xFrictionForce * dt, 0)); // mimics friction
-	else if (skidding())
-		velAdd(Vec2Df(-_vel.versX() * _xSkiddingForce * dt, 0));
+	// batch bodies commit the velocity integrated by the scene, unless
+	// their state changed since then (e.g. by the scheduled actions above)
+	if (!_physicsStore || !_physicsStore->commit(_physicsIndex))
+	{
+		float& vx = state(&PhysicsStore::velX, _vel.x);
+		float& vy = state(&PhysicsStore::velY, _vel.y);
+
+		// velocity backup (useful to determine object state)
+		state(&PhysicsStore::prevVelX, _prevVel.x) = vx;
+		state(&PhysicsStore::prevVelY, _prevVel.y) = vy;
+
+		// gravity, then horizontal accelerations and decelerations
+		// (movement, friction, skidding) with velocity clipping
+		PhysicsStore::integrateVelocity(vx, vy, dirSign(_xDir),
+			gravity(), state(&PhysicsStore::moveForce, _xMoveForce),
+			state(&PhysicsStore::friction, _xFrictionForce), state(&PhysicsStore::skidding, _xSkiddingForce),
+			xVelMax(), yVelMax(), state(&PhysicsStore::velMinX, _xVelMin), state(&PhysicsStore::velMinY, _yVelMin), dt);
+	}
 
 	// move
-	_rect.pos += _vel * dt;
+	_moveStartPos = _rect.pos;
+	_rect.pos += vel() * dt;
+}
+
+Vec2Df MovableObject::predictedVel(float dt) const
+{
+	// same integration of update
+	Vec2Df vel = this->vel();
+	if (_physicsStore && _physicsStore->pending[_physicsIndex])
+		vel = Vec2Df(_physicsStore->nextVelX[_physicsIndex], _physicsStore->nextVelY[_physicsIndex]);
+	else
+		PhysicsStore::integrateVelocity(vel.x, vel.y, dirSign(_xDir),
+			gravity(), state(&PhysicsStore::moveForce, _xMoveForce),
+			state(&PhysicsStore::friction, _xFrictionForce), state(&PhysicsStore::skidding, _xSkiddingForce),
+			xVelMax(), yVelMax(), state(&PhysicsStore::velMinX, _xVelMin), state(&PhysicsStore::velMinY, _yVelMin), dt);
+	return vel;
+}
+
+void MovableObject::enterPhysics(PhysicsStore& store, int i)
+{
+	store.velX[i] = _vel.x;
+	store.velY[i] = _vel.y;
+	store.prevVelX[i] = _prevVel.x;
+	store.prevVelY[i] = _prevVel.y;
+	store.gravity[i] = _yGravityForce;
+	store.moveForce[i] = _xMoveForce;
+	store.friction[i] = _xFrictionForce;
+	store.skidding[i] = _xSkiddingForce;
+	store.velMaxX[i] = _xVelMax;
+	store.velMaxY[i] = _yVelMax;
+	store.velMinX[i] = _xVelMin;
+	store.velMinY[i] = _yVelMin;
+	store.dirX[i] = dirSign(_xDir);
+	_physicsStore = &store;
+}
+
+void MovableObject::leavePhysics(const PhysicsStore& store, int i)
+{
+	_vel = Vec2Df(store.velX[i], store.velY[i]);
+	_prevVel = Vec2Df(store.prevVelX[i], store.prevVelY[i]);
+	_yGravityForce = store.gravity[i];
+	_xMoveForce = store.moveForce[i];
+	_xFrictionForce = store.friction[i];
+	_xSkiddingForce = store.skidding[i];
+	_xVelMax = store.velMaxX[i];
+	_yVelMax = store.velMaxY[i];
+	_xVelMin = store.velMinX[i];
+	_yVelMin = store.velMinY[i];
+	_physicsStore = nullptr;
 }
\ No newline at end of file
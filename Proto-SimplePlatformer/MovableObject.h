@@ -9,6 +9,8 @@
 
 #pragma once
 #include "RenderableObject.h"
+#include "ObjectTypes.h"
+#include "PhysicsStore.h"
 
 namespace agp
 {
@@ -21,11 +23,15 @@ namespace agp
 // - implements free physics (no collisions)
 // - provides physics state queries (falling, midair, ...)
 // - provides basic physics actions (e.g. move, jump, ...)
+// - optionally, integrated in batch by game scenes (see PhysicsStore):
+//   velocity and physics parameters then live in the scene store, and
+//   the getters/setters below are a facade over the object slot
 class agp::MovableObject : public RenderableObject
 {
-	protected:
+	private:
 
-		// physics parameters (expressed in scene units/s)
+		// physics state (expressed in scene units/s) of objects not in a
+		// physics store (stale while in a store: use getters/setters)
 		float _yGravityForce;	// vertical acceleration due to gravity
 		float _xMoveForce;		// horizontal acceleration due to movement
 		float _xFrictionForce;	// horizontal deceleration due to movement release
@@ -34,25 +40,67 @@ class agp::MovableObject : public RenderableObject
 		float _xVelMin;			// minimum horizontal velocity
 		float _yVelMax;			// maximum vertical velocity
 		float _yVelMin;			// minimum vertical velocity
+		Direction _xDir;		// current horizontal movement direction
+		Vec2Df _vel;			// current velocity
+		Vec2Df _prevVel;		// velocity in the previous iteration
+
+		// physics store holding the state, if any (slot = _physicsIndex)
+		PhysicsStore* _physicsStore;
+
+		// physics state field: store slot if in a store, own field otherwise
+		// (writable access discards the pending batch integration)
+		float& state(std::vector<float> PhysicsStore::*array, float& own) { changed(); return _physicsStore ? (_physicsStore->*array)[_physicsIndex] : own; }
+		float state(std::vector<float> PhysicsStore::*array, float own) const { return _physicsStore ? (_physicsStore->*array)[_physicsIndex] : own; }
+		void changed() { if (_physicsStore) _physicsStore->pending[_physicsIndex] = 0; }
+
+	protected:
+
 		float _yJumpImpulse;	// initial vertical velocity when jumping
 		virtual void defaultPhysics();
 
 		// attributes
-		Direction _xDir;		// current horizontal movement direction
-		Vec2Df _vel;			// current velocity
-		Vec2Df _prevVel;		// velocity in the previous iteration
+		PointF _moveStartPos;	// pos before the last integration move
 
 	public:
 
+		// type tag
+		typedef MovableObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << MOVABLE_TYPE; }
+
 		MovableObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer = 0);
 		virtual ~MovableObject() {}
 
 		// getters / setters
-		Vec2Df vel() const { return _vel; }
+		Vec2Df vel() const { return Vec2Df(state(&PhysicsStore::velX, _vel.x), state(&PhysicsStore::velY, _vel.y)); }
+		Vec2Df prevVel() const { return Vec2Df(state(&PhysicsStore::prevVelX, _prevVel.x), state(&PhysicsStore::prevVelY, _prevVel.y)); }
+		void setVel(const Vec2Df& vel) { setVelX(vel.x); setVelY(vel.y); }
+		void setVelX(float vx) { state(&PhysicsStore::velX, _vel.x) = vx; }
+		void setVelY(float vy) { state(&PhysicsStore::velY, _vel.y) = vy; }
 		void velAdd(Vec2Df amount);
 		void velClip(float vx, float vy);
-		void setVelY(float vy) { _vel.y = vy; }
 		void moveBy(Vec2Df amount) { _rect.pos += amount; }
+		Direction xDir() const { return _xDir; }
+		void setXDir(Direction dir);
+
+		// physics parameters getters / setters
+		float gravity() const { return state(&PhysicsStore::gravity, _yGravityForce); }
+		void setGravity(float g) { state(&PhysicsStore::gravity, _yGravityForce) = g; }
+		void setMoveForce(float f) { state(&PhysicsStore::moveForce, _xMoveForce) = f; }
+		void setFriction(float f) { state(&PhysicsStore::friction, _xFrictionForce) = f; }
+		void setSkidding(float f) { state(&PhysicsStore::skidding, _xSkiddingForce) = f; }
+		float xVelMax() const { return state(&PhysicsStore::velMaxX, _xVelMax); }
+		float yVelMax() const { return state(&PhysicsStore::velMaxY, _yVelMax); }
+		void setXVelMax(float v) { state(&PhysicsStore::velMaxX, _xVelMax) = v; }
+		void setYVelMax(float v) { state(&PhysicsStore::velMaxY, _yVelMax) = v; }
+		void setXVelMin(float v) { state(&PhysicsStore::velMinX, _xVelMin) = v; }
+		void setYVelMin(float v) { state(&PhysicsStore::velMinY, _yVelMin) = v; }
+
+		// velocity after the integration of the next step, if unchanged by game logic
+		Vec2Df predictedVel(float dt) const;
+
+		// batch integration (default: off): takes effect when the object
+		// enters the scene (to be called in constructors)
+		void setBatchPhysics(bool on) { _batchPhysics = on; }
 
 		// state queries
 		bool skidding() const;
@@ -67,6 +115,10 @@ class agp::MovableObject : public RenderableObject
 		// extends game logic (+physics)
 		virtual void update(float dt) override;
 
+		// implements batch physics state move to/from the store
+		virtual void enterPhysics(PhysicsStore& store, int i) override;
+		virtual void leavePhysics(const PhysicsStore& store, int i) override;
+
 		virtual std::string name() override {
 			return strprintf("MovableObject[%d]", _id);
 		}
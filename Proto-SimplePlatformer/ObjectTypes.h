@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "Object.h"
+
+namespace agp
+{
+	// type bits of game classes (see Object::is)
+	enum GameTypeBits
+	{
+		MOVABLE_TYPE = GAME_TYPES,
+		COLLIDABLE_TYPE,
+		STATIC_TYPE,
+		DYNAMIC_TYPE,
+		KINEMATIC_TYPE,
+		BLOCK_TYPE,
+		LIFT_TYPE,
+		TRIGGER_TYPE,
+		ENEMY_TYPE,
+		HAMMER_TYPE,
+		HAMMERBROTHER_TYPE,
+		SWORD_TYPE,
+		KNIGHT_TYPE,
+		MARIO_TYPE,
+		MENUITEM_TYPE,
+		CHAIN_TYPE,
+		TILELAYER_TYPE
+	};
+
+	// collision categories of game objects (see CollidableObject::setCollisionFilter)
+	enum CollisionCategories : CollisionMask
+	{
+		TERRAIN_CATEGORY = 1 << 0,		// default: static/kinematic objects, triggers
+		DYNAMIC_CATEGORY = 1 << 1,		// dynamic objects (e.g. sword)
+		ENEMY_CATEGORY   = 1 << 2,
+		KNIGHT_CATEGORY  = 1 << 3,
+		MARIO_CATEGORY   = 1 << 4,
+		DYNAMIC_CATEGORIES = DYNAMIC_CATEGORY | ENEMY_CATEGORY | KNIGHT_CATEGORY | MARIO_CATEGORY,
+		ALL_CATEGORIES = ~CollisionMask(0)
+	};
+}
@@ -18,17 +18,32 @@
 
 using namespace agp;
 
-PlatformerGame::PlatformerGame() : Game("Platformer Game", { 720,720 }, 25.0f/14)
+PlatformerGame::PlatformerGame(bool headless, const std::string& level) : Game("Platformer Game", { 720,720 }, 25.0f/14, headless)
 {
 	_hud = nullptr;
+	_level = level;
 }
 
 void PlatformerGame::init()
 {
-	pushScene(LevelLoader::instance()->load("overworld"));
+	// batch runs count frames from the start: level loaded upfront
+	std::string level = _level;
+	if (headless() || turbo())
+	{
+		Scene* world = LevelLoader::instance()->load(level);
+		if (!world)
+			throw "Cannot load level " + level;
+		pushScene(world);
+	}
+	else
+		pushSceneAsync([level]() { return LevelLoader::instance()->load(level); }, loadingScreen());
+
 	_hud = new HUD();
 	pushScene(_hud);
-	pushScene(Menu::mainMenu());
+
+	// no one to close the main menu in batch runs (it would block the game)
+	if (!headless() && !turbo())
+		pushScene(Menu::mainMenu());
 }
 
 void PlatformerGame::freeze(bool on)
@@ -43,6 +58,14 @@ void PlatformerGame::freeze(bool on)
 	}
 }
 
+Scene* PlatformerGame::loadingScreen()
+{
+	UIScene* loadingScreen = new UIScene(RectF(0, 0, 16, 15), { 16, 16 });
+	loadingScreen->setBackgroundColor(Color(0, 0, 0));
+	new RenderableObject(loadingScreen, RectF(5.5, 7, 5, 0.5), SpriteFactory::instance()->getText("LOADING", { 0.5f, 0.5f }));
+	return loadingScreen;
+}
+
 void PlatformerGame::gameover()
 {
 	UIScene* gameoverScreen = new UIScene(RectF(0, 0, 16, 15), { 16, 16 });
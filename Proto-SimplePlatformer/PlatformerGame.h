@@ -8,6 +8,7 @@
 // ----------------------------------------------------------------
 
 #pragma once
+#include <string>
 #include "Game.h"
 
 namespace agp
@@ -18,15 +19,21 @@ namespace agp
 
 // PlatformerGame
 // - customizes parent's class Game to adapt to simple platformer games
+// - builds the level on a background thread behind a loading screen
+// - starts from the given level (see LevelLoader)
 class agp::PlatformerGame : public Game
 { 
 	protected:
 
 		HUD* _hud;
+		std::string _level;		// level to start from
+
+		// shown while the level is built
+		Scene* loadingScreen();
 
 	public: 
 		
-		PlatformerGame();
+		PlatformerGame(bool headless = false, const std::string& level = "overworld");
 		HUD* hud() { return _hud; }
 
 		virtual void init() override;
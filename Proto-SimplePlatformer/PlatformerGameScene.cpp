@@ -23,6 +23,12 @@ PlatformerGameScene::PlatformerGameScene(const RectF& rect, const Point& pixelUn
 {
 	// NES aspect ratio (16 x 15)
 	_view->setRect(RectF(0, 39, 25, 14));
+
+	// long levels: only objects near the camera are simulated, the others
+	// are suspended (the margin covers the range of a thrown hammer, so
+	// off-screen Hammer Brothers are already throwing when they show up)
+	setActivationEnabled(true);
+	setActivationMargin(8, 2);
 }
 
 void PlatformerGameScene::updateControls(float timeToSimulate)
@@ -28,7 +28,8 @@ SpriteFactory::SpriteFactory()
 		return;
 	}
 
-	SDL_Renderer* renderer = Game::instance()->window()->renderer();
+	// headless: no textures, sprites keep their frames only
+	SDL_Renderer* renderer = Game::instance()->headless() ? nullptr : Game::instance()->window()->renderer();
 	_spriteSheets["sky_bg"] = loadTexture(renderer, std::string(SOURCE_DIR) + "sprites/sky_bg.png");
 	_spriteSheets["castle_bg"] = loadTexture(renderer, std::string(SOURCE_DIR) + "sprites/castle_prova.png");
 	_spriteSheets["trees1_bg"] = loadTexture(renderer, std::string(SOURCE_DIR) + "sprites/trees1_prova.png");
@@ -38,7 +39,12 @@ SpriteFactory::SpriteFactory()
 	_spriteSheets["hud"] = loadTexture(renderer, std::string(SOURCE_DIR)+ "sprites/hud.png", { 147, 187, 236 });
 	_spriteSheets["tiles"] = loadTextureAutoDetect(renderer, std::string(SOURCE_DIR) + "sprites/stage_tiles.png", _autoTiles["tiles"], { 27, 89, 153 }, { 147, 187, 236 }, 5, true, false);
 	_spriteSheets["overworld"] = loadTexture(renderer, std::string(SOURCE_DIR) + "sprites/overworld.png");
+	_spriteSheets["level_1-1"] = loadTexture(renderer, std::string(SOURCE_DIR) + "levels/1-1.png");
 	_spriteSheets["knight"] = loadTextureAutoDetect(renderer, std::string(SOURCE_DIR) + "sprites/knight.png", _autoTiles["knight"], { 0, 128, 128 }, { 0, 255, 0 }, 5, true, false, true);
+
+	for (auto& entry : _spriteSheets)
+		if (entry.second)
+			SDL_QueryTexture(entry.second, nullptr, nullptr, &_sheetRects[entry.first].size.x, &_sheetRects[entry.first].size.y);
 }
 
 // anchors
@@ -50,21 +56,24 @@ static RectI hud_coin(519, 289, 8, 8);
 
 Sprite* SpriteFactory::get(const std::string& id)
 {
+	std::lock_guard<std::mutex> lock(_mutex);
 	std::vector< RectI> rects;
 
 	// overworld
 	if (id == "overworld")
-		return new Sprite(_spriteSheets["overworld"]);
+		return new Sprite(_spriteSheets["overworld"], _sheetRects["overworld"]);
+	else if (id == "level_1-1")
+		return new Sprite(_spriteSheets["level_1-1"], _sheetRects["level_1-1"]);
 
 	// background
 	else if (id == "sky_bg")
-		return new Sprite(_spriteSheets["sky_bg"]);
+		return new Sprite(_spriteSheets["sky_bg"], _sheetRects["sky_bg"]);
 	else if (id == "castle_bg")
-		return new FilledSprite(_spriteSheets["castle_bg"]);
+		return new FilledSprite(_spriteSheets["castle_bg"], _sheetRects["castle_bg"]);
 	else if (id == "trees1_bg")
-		return new FilledSprite(_spriteSheets["trees1_bg"]);
+		return new FilledSprite(_spriteSheets["trees1_bg"], _sheetRects["trees1_bg"]);
 	else if (id == "trees2_bg")
-		return new FilledSprite(_spriteSheets["trees2_bg"]);
+		return new FilledSprite(_spriteSheets["trees2_bg"], _sheetRects["trees2_bg"]);
 
 
 	// single-frame sprites
@@ -138,6 +147,7 @@ Sprite* SpriteFactory::get(const std::string& id)
 
 Sprite* SpriteFactory::getText(std::string text, const Vec2Df& size, int fillN, char fillChar, bool enabled)
 {
+	std::lock_guard<std::mutex> lock(_mutex);
 	std::vector< RectI> tiles;
 
 	if (fillN)
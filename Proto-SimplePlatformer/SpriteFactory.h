@@ -10,6 +10,7 @@
 #pragma once
 #include <map>
 #include <string>
+#include <mutex>
 #include "SDL.h"
 #include "geometryUtils.h"
 #include "Singleton.h"
@@ -22,7 +23,8 @@ namespace agp
 
 // SpriteFactory (singleton)
 // - loads spritesheets
-// - instances sprites by id
+// - instances sprites by id, from any thread (e.g. level loading): sheets
+//   are uploaded once at startup, sprites only reference them
 class agp::SpriteFactory : public Singleton<SpriteFactory>
 {
 	friend class Singleton<SpriteFactory>;
@@ -31,6 +33,8 @@ class agp::SpriteFactory : public Singleton<SpriteFactory>
 
 		std::map<std::string, SDL_Texture*> _spriteSheets;
 		std::map<std::string, std::vector< std::vector<RectI > > > _autoTiles;
+		std::map<std::string, RectI> _sheetRects;		// whole sheets (no texture queries when loading)
+		std::mutex _mutex;
 
 		// constructor accessible only to Singleton (thanks to friend declaration)
 		SpriteFactory();
@@ -8,12 +8,37 @@
 // ----------------------------------------------------------------
 
 #include "StaticObject.h"
-#include "Scene.h"
+#include "GameScene.h"
 
 using namespace agp;
 
 StaticObject::StaticObject(Scene* scene, const RotatedRectF& rect, Sprite* sprite, int layer) :
 	CollidableObject(scene, rect, sprite, layer)
-{	
+{
+	_typeMask |= typeBit();	
+	_static = true;
+}
 
+void StaticObject::setRect(const RectF& rect)
+{
+	CollidableObject::setRect(rect);
+
+	if (_gameScene)
+		_gameScene->invalidateStaticIndex();
+}
+
+void StaticObject::setPos(const PointF& newPos)
+{
+	CollidableObject::setPos(newPos);
+
+	if (_gameScene)
+		_gameScene->invalidateStaticIndex();
+}
+
+void StaticObject::setSize(const PointF& newSize)
+{
+	CollidableObject::setSize(newSize);
+
+	if (_gameScene)
+		_gameScene->invalidateStaticIndex();
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ namespace agp
 // StaticObject class.
 // - provides base class for all objects that do not generally update physics
 //   nor detect/resolve collisions
+// - flagged as static, hence indexed once by the game scene (see BVH)
 class agp::StaticObject : public CollidableObject
 {
 	protected:
@@ -25,9 +26,18 @@ class agp::StaticObject : public CollidableObject
 
 	public:
 
+		// type tag
+		typedef StaticObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << STATIC_TYPE; }
+
 		StaticObject(Scene* scene, const RotatedRectF& rect, Sprite* sprite, int layer = 0);
 		virtual ~StaticObject() {}
 
+		// extends setters (+static index invalidation)
+		virtual void setRect(const RectF& rect) override;
+		virtual void setPos(const PointF& newPos) override;
+		virtual void setSize(const PointF& newSize) override;
+
 		// extends game logic (-physics, -collisions)
 		virtual void update(float dt) override { RenderableObject::update(dt); }
 
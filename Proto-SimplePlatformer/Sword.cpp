@@ -19,9 +19,11 @@ using namespace agp;
 Sword::Sword(Mario* mario)
 	: DynamicObject(mario->scene(), RectF(mario->pos().x, mario->pos().y, 2, 2), nullptr, mario->layer() - 1)
 {
+	_typeMask |= typeBit();
+	setCollisionFilter(DYNAMIC_CATEGORY, ENEMY_CATEGORY);	// Enemy only
 	_link = mario;
 	_facingDir = _link->facingDir();
-	_yGravityForce = 0;
+	setGravity(0);
 	_CCD = false;
 
 	setSprite(SpriteFactory::instance()->get("link_sword"));
@@ -62,14 +64,9 @@ void Sword::update(float dt)
 	DynamicObject::update(dt);
 }
 
-bool Sword::collidableWith(CollidableObject* obj)
-{
-	return dynamic_cast<Enemy*>(obj);
-}
-
 bool Sword::collision(CollidableObject* with, Direction fromDir)
 {
-	Enemy* enemy = dynamic_cast<Enemy*>(with);
+	Enemy* enemy = with->to<Enemy*>();
 	if (enemy)
 		enemy->smash();
 
@@ -25,6 +25,10 @@ class agp::Sword : public DynamicObject
 
 	public:
 
+		// type tag
+		typedef Sword TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << SWORD_TYPE; }
+
 		Sword(Mario* link);
 		virtual ~Sword() {}
 
@@ -34,9 +38,6 @@ class agp::Sword : public DynamicObject
 		// extends logic collision (+hurt enemies)
 		virtual bool collision(CollidableObject* with, Direction fromDir) override;
 
-		// extends collision logic (+collision with Enemy only)
-		virtual bool collidableWith(CollidableObject* obj) override;
-
 		virtual std::string name() override { 
 			return strprintf("Sword[%d]", _id); 
 		}
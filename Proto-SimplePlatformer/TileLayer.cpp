@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "TileLayer.h"
+#include "GameScene.h"
+#include "View.h"
+#include "RenderSnapshot.h"
+
+using namespace agp;
+
+TileLayer::TileLayer(Scene* scene, const TileGrid& tiles, Sprite* sprite, int layer) :
+	StaticObject(scene, RotatedRectF(tiles.rect()), sprite, layer), _tiles(tiles)
+{
+	_typeMask |= typeBit();
+	_shaped = true;
+}
+
+bool TileLayer::sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time)
+{
+	// oriented movers collide with their bounding rect
+	return _tiles.sweptRect(source, sweep, normal, time);
+}
+
+bool TileLayer::overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth)
+{
+	return _tiles.overlap(other->sceneCollider(), axis, depth);
+}
+
+void TileLayer::draw(SDL_Renderer* renderer, Transform camera)
+{
+	MovableObject::draw(renderer, camera);
+
+	// solid tiles within the view only
+	if (_gameScene && _gameScene->collidersVisible())
+	{
+		SDL_SetRenderDrawColor(renderer, _colliderColor.r, _colliderColor.g, _colliderColor.b, _colliderColor.a);
+		RectI range = _tiles.tileRange(_scene->view()->rect());
+		for (int row = range.pos.y; row < range.pos.y + range.size.y; row++)
+			for (int col = range.pos.x; col < range.pos.x + range.size.x; col++)
+				if (_tiles.solid(col, row))
+				{
+					RectF tile = _tiles.tileRect(col, row);
+					SDL_FRect drawRect = RectF(camera(tile.pos), camera(tile.pos + tile.size)).toSDLf();
+					SDL_RenderDrawRectF(renderer, &drawRect);
+				}
+	}
+}
+
+void TileLayer::snapshot(RenderSnapshot& snapshot)
+{
+	MovableObject::snapshot(snapshot);
+
+	// solid tiles within the view only
+	if (_gameScene && _gameScene->collidersVisible())
+	{
+		RectI range = _tiles.tileRange(_scene->view()->rect());
+		for (int row = range.pos.y; row < range.pos.y + range.size.y; row++)
+			for (int col = range.pos.x; col < range.pos.x + range.size.x; col++)
+				if (_tiles.solid(col, row))
+					snapshot.addRect(_tiles.tileRect(col, row), _colliderColor, Vec2Df());
+	}
+}
@@ -0,0 +1,57 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "StaticObject.h"
+#include "TileGrid.h"
+
+namespace agp
+{
+	class TileLayer;
+}
+
+// TileLayer class
+// - static collider made of the solid tiles of a tile grid (e.g. imported
+//   from a level bitmap), a single scene object for the whole level
+// - movers collide with the tiles around them only (direct lookup, constant
+//   cost per mover whatever the level size)
+// - tiles are in scene coordinates: the layer is not meant to be moved
+class agp::TileLayer : public StaticObject
+{
+	protected:
+
+		TileGrid _tiles;
+
+	public:
+
+		// type tag
+		typedef TileLayer TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << TILELAYER_TYPE; }
+
+		TileLayer(Scene* scene, const TileGrid& tiles, Sprite* sprite = nullptr, int layer = 0);
+		virtual ~TileLayer() {}
+
+		// getters
+		const TileGrid& tiles() const { return _tiles; }
+
+		// overrides geometric queries (+tiles)
+		virtual bool intersectsLine(const LineF& line, float& tNear) override { return _tiles.raycast(line, tNear); }
+
+		// implements exact collision tests (+tiles)
+		virtual bool sweptContactFrom(CollidableObject* mover, const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time) override;
+		virtual bool overlapFrom(CollidableObject* other, Vec2Df& axis, float& depth) override;
+
+		// extends rendering (+solid tiles)
+		virtual void draw(SDL_Renderer* renderer, Transform camera) override;
+		virtual void snapshot(RenderSnapshot& snapshot) override;
+
+		virtual std::string name() override {
+			return strprintf("TileLayer[%d]", _id);
+		}
+};
@@ -8,25 +8,58 @@
 // ----------------------------------------------------------------
 
 #include "Trigger.h"
+#include "GameScene.h"
+#include "RenderSnapshot.h"
+#include <iostream>
 
 using namespace agp;
 
-Trigger::Trigger(Scene* scene, const RectF& rect, CollidableObject* watched, std::function<void()> task) :
-	CollidableObject(scene, rect, nullptr)
+Trigger::Trigger(Scene* scene, const RectF& rect, Object* watched, std::function<void()> task) :
+	Trigger(scene, rect, [task](Object*, TriggerSystem::Event event) { if (event == TriggerSystem::Event::ENTER) task(); }, watched)
 {
-	_task = task;
-	_watched = watched;
-	_compenetrable = true;
 }
 
-// extends logic collision (+trigger behavior)
-bool Trigger::collision(CollidableObject* with, Direction fromDir)
+Trigger::Trigger(Scene* scene, const RectF& rect, TriggerSystem::Handler handler, Object* watched) :
+	RenderableObject(scene, rect, nullptr)
 {
-	if (with == _watched)
+	_typeMask |= typeBit();
+	_static = true;
+	_volume = -1;
+
+	GameScene* gameScene = dynamic_cast<GameScene*>(_scene);
+	if (gameScene)
 	{
-		_task();
-		return true;
+		_volume = gameScene->triggers().add(rect, handler, watched);
+		if (watched)
+			gameScene->triggers().watch(watched);
 	}
 	else
-		return false;
+		std::cerr << name() << ": triggers require a game scene\n";
+}
+
+Trigger::~Trigger()
+{
+	// no game scene while the scene is being destroyed
+	GameScene* gameScene = dynamic_cast<GameScene*>(_scene);
+	if (gameScene)
+		gameScene->triggers().remove(_volume);
+}
+
+void Trigger::draw(SDL_Renderer* renderer, Transform camera)
+{
+	GameScene* gameScene = dynamic_cast<GameScene*>(_scene);
+	if (gameScene && gameScene->collidersVisible())
+	{
+		auto vertices = _rect.vertices();
+		SDL_FRect drawRect = RectF(camera(vertices[0]), camera(vertices[2])).toSDLf();
+		SDL_SetRenderDrawColor(renderer, _volumeColor.r, _volumeColor.g, _volumeColor.b, _volumeColor.a);
+		SDL_RenderDrawRectF(renderer, &drawRect);
+	}
+}
+
+void Trigger::snapshot(RenderSnapshot& snapshot)
+{
+	GameScene* gameScene = dynamic_cast<GameScene*>(_scene);
+	if (gameScene && gameScene->collidersVisible())
+		snapshot.addRect(_rect, _volumeColor, Vec2Df());
 }
\ No newline at end of file
@@ -9,7 +9,9 @@
 
 #pragma once
 #include <functional>
-#include "CollidableObject.h"
+#include "RenderableObject.h"
+#include "TriggerSystem.h"
+#include "ObjectTypes.h"
 
 namespace agp
 {
@@ -17,23 +19,30 @@ namespace agp
 }
 
 // Trigger class
-// -  performs a given task when collides with given object
-class agp::Trigger : public CollidableObject
+// - trigger volume of the game scene (see TriggerSystem): no physics, no
+//   collisions, tested only against the watchers (e.g. player)
+// - performs a given task when the watched object enters the volume,
+//   or handles enter/stay/exit events of any watcher
+class agp::Trigger : public RenderableObject
 {
 	private:
 
-		std::function<void()> _task;
-		CollidableObject* _watched;
+		int _volume;	// id in the scene trigger system (-1 if none)
+		const Color _volumeColor = { 0, 255, 255, 255 };
 
 	public:
 
-		Trigger(Scene* scene, const RectF& rect, CollidableObject* watched, std::function<void()> task);
+		// type tag
+		typedef Trigger TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << TRIGGER_TYPE; }
 
-		// extends game logic (-physics, -collisions)
-		virtual void update(float dt) override { RenderableObject::update(dt); }
+		Trigger(Scene* scene, const RectF& rect, Object* watched, std::function<void()> task);
+		Trigger(Scene* scene, const RectF& rect, TriggerSystem::Handler handler, Object* watched = nullptr);
+		virtual ~Trigger();
 
-		// extends logic collision (+trigger behavior)
-		virtual bool collision(CollidableObject* with, Direction fromDir) override;
+		// extends rendering (+volume)
+		virtual void draw(SDL_Renderer* renderer, Transform camera) override;
+		virtual void snapshot(RenderSnapshot& snapshot) override;
 
 		virtual std::string name() override {
 			return strprintf("Trigger[%d]", _id);
@@ -1,3 +1,6 @@
+#include <string>
+#include <cctype>
+#include <cstdlib>
 #include "Window.h"
 #include "SpriteFactory.h"
 #include "LevelLoader.h"
@@ -14,12 +17,62 @@
 
 int main(int argc, char *argv[])
 {
+	// --headless [frames]: no window nor audio, fixed frame time, until quit or frames are run
+	// --turbo steps: fixed steps per loop iteration, not tied to the wall clock
+	// --turbo-time seconds: turbo run over after the given simulated time (implies --turbo 1)
+	// --render-every n: turbo renders every n iterations (0 = never)
+	// --sim-thread [rate]: simulation on its own thread at rate updates/s, decoupled from rendering
+	// --level name: level to start from (e.g. overworld, 1-1)
+	bool headless = false;
+	int headlessFrames = 0;
+	int turboSteps = 0;
+	float turboTime = 0;
+	int renderEvery = 1;
+	bool simThread = false;
+	float simRate = 0;
+	std::string level = "overworld";
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc && std::isdigit(argv[i + 1][0]);
+		if (arg == "--headless")
+		{
+			headless = true;
+			if (hasValue)
+				headlessFrames = std::atoi(argv[++i]);
+		}
+		else if (arg == "--turbo" && hasValue)
+			turboSteps = std::atoi(argv[++i]);
+		else if (arg == "--turbo-time" && hasValue)
+			turboTime = float(std::atof(argv[++i]));
+		else if (arg == "--render-every" && hasValue)
+			renderEvery = std::atoi(argv[++i]);
+		else if (arg == "--level" && i + 1 < argc)
+			level = argv[++i];
+		else if (arg == "--sim-thread")
+		{
+			simThread = true;
+			if (hasValue)
+				simRate = float(std::atof(argv[++i]));
+		}
+		else
+			printf("Unknown or incomplete option %s\n", argv[i]);
+	}
+	if (turboTime > 0 && !turboSteps)
+		turboSteps = 1;
+
 	printf("Proto-SimplePlatformer v%s\n", agp::SimplePlatformer::VERSION().c_str());
 	printf("Core v%s\n\n", agp::core::VERSION().c_str());
 
 	try
 	{
-		agp::Game::setInstance(new agp::PlatformerGame());
+		agp::Game::setInstance(new agp::PlatformerGame(headless, level));
+		agp::Game::instance()->setHeadlessRun(headlessFrames);
+		if (turboSteps)	// one level timestep per turbo step (see LevelLoader)
+			agp::Game::instance()->setTurbo(turboSteps, 1 / 100.0f, turboTime, renderEvery);
+		agp::Game::instance()->setSimulationThread(simThread);
+		if (simRate > 0)
+			agp::Game::instance()->setSimulationRate(simRate);
 		agp::SpriteFactory::instance();
 		agp::LevelLoader::instance();
 		agp::Audio::instance();
@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <iostream>
+#include <cstdlib>
+#include "Game.h"
+#include "UIScene.h"
+#include "ChainObject.h"
+#include "DynamicObject.h"
+
+using namespace agp;
+
+// ChainObject tests
+// - a box sliding on two collinear segments crosses their shared vertex
+//   without being stopped by it (no wall nor backward contact normals,
+//   whichever edge/vertex case of the swept test reports the contact)
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << "\n";
+		failures++;
+	}
+}
+
+static void slideAcrossVertex(ChainObject* chain, DynamicObject* box, const RectF& source, const Vec2Df& sweep, bool hits)
+{
+	Vec2Df normal;
+	float time;
+	std::string what = strprintf("box at (%g, %g) swept by (%g, %g)", source.pos.x, source.pos.y, sweep.x, sweep.y);
+	bool hit = chain->sweptContactFrom(box, source, sweep, normal, time);
+	check(hit || !hits, what + ": ground contact expected");
+	if (!hit)
+		return;
+
+	// contact with the ground only: normal pointing up (y down), never against the motion
+	check(std::abs(normal.x) < 1e-4f, what + ": wall normal at the vertex");
+	check(normal.dot(sweep) <= 1e-6f, what + ": normal along the motion");
+	check(normal.y < 0, what + ": ground normal expected");
+}
+
+int main(int argc, char* argv[])
+{
+	// no window: views query the game for the output size
+	Game::setInstance(new Game("ChainObjectTest", { 600, 600 }, -1, true));
+	UIScene scene(RectF(0, 0, 20, 20), { 16, 16 });
+
+	// flat ground made of two collinear segments sharing the vertex at x = 5
+	ChainObject* chain = new ChainObject(&scene, { PointF(0, 10), PointF(5, 10), PointF(10, 10) });
+	DynamicObject* box = new DynamicObject(&scene, RectF(3.9f, 9, 1, 1), nullptr);
+
+	// right edge reaching the vertex: resting, falling a little, slightly above the ground
+	float heights[] = { 9, 9.0001f, 8.9999f };
+	Vec2Df sweeps[] = { { 0.3f, 0 }, { 0.3f, 0.01f }, { 0.3f, 0.002f }, { -0.3f, 0.01f } };
+	for (float y : heights)
+		for (auto& sweep : sweeps)
+		{
+			float x = sweep.x > 0 ? 3.9f : 5.2f;		// leading edge just before the vertex
+			slideAcrossVertex(chain, box, RectF(x, y, 1, 1), sweep, y < 9 && sweep.y > 0);
+		}
+
+	if (failures)
+		std::cerr << failures << " checks failed\n";
+	else
+		std::cout << "ChainObject tests passed\n";
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -8,6 +8,7 @@
 // ----------------------------------------------------------------
 
 #include "Audio.h"
+#include "Game.h"
 #include "SDL.h"
 #include "fileUtils.h"
 #include <iostream>
@@ -16,6 +17,10 @@ using namespace agp;
 
 Audio::Audio()
 {
+	_enabled = !Game::instance()->headless();
+	if (!_enabled)
+		return;
+
 	if (SDL_Init(SDL_INIT_AUDIO))
 		throw SDL_GetError();
 
@@ -56,11 +61,15 @@ Audio::~Audio()
 	for (auto& entry : _sounds)
 		Mix_FreeChunk(entry.second);
 
-	Mix_CloseAudio();
+	if (_enabled)
+		Mix_CloseAudio();
 }
 
 void Audio::playSound(const std::string& id, int loops)
 {
+	if (!_enabled)
+		return;
+
 	if (_sounds.find(id) == _sounds.end())
 	{
 		std::cerr << "Cannot find sound \"" << id << "\"\n";
@@ -72,6 +81,9 @@ void Audio::playSound(const std::string& id, int loops)
 
 void Audio::playMusic(const std::string& id, int loops)
 {
+	if (!_enabled)
+		return;
+
 	if (_musics.find(id) == _musics.end())
 	{
 		std::cerr << "Cannot find music \"" << id << "\"\n";
@@ -83,15 +95,18 @@ void Audio::playMusic(const std::string& id, int loops)
 
 void Audio::resumeMusic()
 {
-	Mix_ResumeMusic();
+	if (_enabled)
+		Mix_ResumeMusic();
 }
 
 void Audio::pauseMusic()
 {
-	Mix_PauseMusic();
+	if (_enabled)
+		Mix_PauseMusic();
 }
 
 void Audio::haltMusic()
 {
-	Mix_HaltMusic();
+	if (_enabled)
+		Mix_HaltMusic();
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace agp
 // Audio (singleton)
 // - loads all sounds and musics once when started
 // - offers methods to play/control sounds and musics indexed by id
+// - silent (no device, nothing loaded) if the game is headless
 class agp::Audio : public Singleton<Audio>
 {
 	friend class Singleton<Audio>;
@@ -30,6 +31,7 @@ class agp::Audio : public Singleton<Audio>
 
 		std::map< std::string, Mix_Chunk*> _sounds;
 		std::map< std::string, Mix_Music*> _musics;
+		bool _enabled;
 
 		// constructor accessible only to Singleton (thanks to friend declaration)
 		Audio();
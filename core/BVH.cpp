@@ -0,0 +1,248 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include "BVH.h"
+#include "Object.h"
+
+using namespace agp;
+
+// inclusive AABB overlap (independent of yUp since pos is always the min corner)
+static inline bool overlaps(const RectF& a, const RectF& b)
+{
+	return
+		a.pos.x <= b.pos.x + b.size.x && b.pos.x <= a.pos.x + a.size.x &&
+		a.pos.y <= b.pos.y + b.size.y && b.pos.y <= a.pos.y + a.size.y;
+}
+
+// inclusive segment vs. AABB test (slab method), also yields the entry parameter
+static inline bool overlaps(const RectF& r, const LineF& line, float& tEnter)
+{
+	float t0 = 0, t1 = 1;
+	float d[2] = { line.end.x - line.start.x, line.end.y - line.start.y };
+	float p[2] = { line.start.x, line.start.y };
+	float lo[2] = { r.pos.x, r.pos.y };
+	float hi[2] = { r.pos.x + r.size.x, r.pos.y + r.size.y };
+
+	for (int a = 0; a < 2; a++)
+	{
+		if (d[a] == 0)
+		{
+			if (p[a] < lo[a] || p[a] > hi[a])
+				return false;
+			continue;
+		}
+		float tA = (lo[a] - p[a]) / d[a];
+		float tB = (hi[a] - p[a]) / d[a];
+		if (tA > tB)
+			std::swap(tA, tB);
+		t0 = std::max(t0, tA);
+		t1 = std::min(t1, tB);
+		if (t0 > t1)
+			return false;
+	}
+	tEnter = t0;
+	return true;
+}
+
+static inline bool overlaps(const RectF& r, const LineF& line)
+{
+	float tEnter;
+	return overlaps(r, line, tEnter);
+}
+
+void BVH::clear()
+{
+	_nodes.clear();
+	_items.clear();
+}
+
+void BVH::build(const std::vector<Object*>& objects)
+{
+	clear();
+	if (objects.empty())
+		return;
+
+	_items = objects;
+	_nodes.reserve(2 * (_items.size() / LEAF_SIZE + 1));
+	_nodes.push_back(Node());
+	build(0, 0, int(_items.size()));
+}
+
+RectF BVH::bounds(int first, int count) const
+{
+	RectF r = _items[first]->rect();
+	PointF minP = r.pos;
+	PointF maxP = r.pos + r.size;
+	for (int i = first + 1; i < first + count; i++)
+	{
+		const RectF& ri = _items[i]->rect();
+		minP.x = std::min(minP.x, ri.pos.x);
+		minP.y = std::min(minP.y, ri.pos.y);
+		maxP.x = std::max(maxP.x, ri.pos.x + ri.size.x);
+		maxP.y = std::max(maxP.y, ri.pos.y + ri.size.y);
+	}
+
+	return RectF(minP, maxP, r.yUp);
+}
+
+void BVH::build(int nodeIndex, int first, int count)
+{
+	RectF nodeBounds = bounds(first, count);
+	_nodes[nodeIndex].bounds = nodeBounds;
+	_nodes[nodeIndex].categories = 0;
+	for (int i = first; i < first + count; i++)
+		_nodes[nodeIndex].categories |= _items[i]->collisionCategory();
+
+	if (count <= LEAF_SIZE)
+	{
+		_nodes[nodeIndex].first = first;
+		_nodes[nodeIndex].count = count;
+		return;
+	}
+
+	// median split of objects centers along the longest axis
+	bool splitX = nodeBounds.size.x >= nodeBounds.size.y;
+	int half = count / 2;
+	std::nth_element(_items.begin() + first, _items.begin() + first + half, _items.begin() + first + count,
+		[splitX](Object* a, Object* b)
+		{
+			const RectF& ra = a->rect();
+			const RectF& rb = b->rect();
+			return splitX ?
+				ra.pos.x + ra.size.x / 2 < rb.pos.x + rb.size.x / 2 :
+				ra.pos.y + ra.size.y / 2 < rb.pos.y + rb.size.y / 2;
+		});
+
+	// children are allocated contiguously (NOTE: _nodes may reallocate here)
+	int left = int(_nodes.size());
+	_nodes.push_back(Node());
+	_nodes.push_back(Node());
+	_nodes[nodeIndex].first = left;
+	_nodes[nodeIndex].count = 0;
+
+	build(left, first, half);
+	build(left + 1, first + half, count - half);
+}
+
+void BVH::query(const RectF& r, std::vector<Object*>& result) const
+{
+	query(r, result, ANY_CATEGORY);
+}
+
+void BVH::query(const RectF& r, std::vector<Object*>& result, CollisionMask categories) const
+{
+	if (_nodes.empty())
+		return;
+
+	int stack[MAX_DEPTH];
+	int top = 0;
+	stack[top++] = 0;
+	while (top)
+	{
+		const Node& node = _nodes[stack[--top]];
+		if (!overlaps(node.bounds, r) || (categories != ANY_CATEGORY && !(node.categories & categories)))
+			continue;
+
+		if (node.count)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+				if (overlaps(_items[i]->rect(), r) &&
+					(categories == ANY_CATEGORY || (_items[i]->collisionCategory() & categories)))
+					result.push_back(_items[i]);
+		}
+		else
+		{
+			stack[top++] = node.first + 1;
+			stack[top++] = node.first;
+		}
+	}
+}
+
+void BVH::query(const LineF& line, std::vector<Object*>& result) const
+{
+	if (_nodes.empty())
+		return;
+
+	int stack[MAX_DEPTH];
+	int top = 0;
+	stack[top++] = 0;
+	while (top)
+	{
+		const Node& node = _nodes[stack[--top]];
+		if (!overlaps(node.bounds, line))
+			continue;
+
+		if (node.count)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+				if (overlaps(_items[i]->rect(), line))
+					result.push_back(_items[i]);
+		}
+		else
+		{
+			stack[top++] = node.first + 1;
+			stack[top++] = node.first;
+		}
+	}
+}
+
+void BVH::raycast(const LineF& line, const RayVisitor& visitor) const
+{
+	if (_nodes.empty())
+		return;
+
+	float tLimit = 1;
+	float tEnter;
+	if (!overlaps(_nodes[0].bounds, line, tEnter))
+		return;
+
+	// stack of (node, entry parameter): the nearest child is popped first
+	std::pair<int, float> stack[MAX_DEPTH];
+	int top = 0;
+	stack[top++] = { 0, tEnter };
+	while (top)
+	{
+		std::pair<int, float> entry = stack[--top];
+		if (entry.second > tLimit)
+			continue;
+
+		const Node& node = _nodes[entry.first];
+		if (node.count)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+				if (overlaps(_items[i]->rect(), line, tEnter) && tEnter <= tLimit)
+				{
+					tLimit = visitor(_items[i]);
+					if (tLimit < 0)
+						return;
+				}
+		}
+		else
+		{
+			float tLeft, tRight;
+			bool hitLeft = overlaps(_nodes[node.first].bounds, line, tLeft);
+			bool hitRight = overlaps(_nodes[node.first + 1].bounds, line, tRight);
+			if (hitLeft && hitRight && tLeft <= tRight)
+			{
+				stack[top++] = { node.first + 1, tRight };
+				stack[top++] = { node.first, tLeft };
+			}
+			else if (hitLeft && hitRight)
+			{
+				stack[top++] = { node.first, tLeft };
+				stack[top++] = { node.first + 1, tRight };
+			}
+			else if (hitLeft)
+				stack[top++] = { node.first, tLeft };
+			else if (hitRight)
+				stack[top++] = { node.first + 1, tRight };
+		}
+	}
+}
@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <functional>
+#include "geometryUtils.h"
+#include "Object.h"
+
+namespace agp
+{
+	class Object;
+	class BVH;
+}
+
+// BVH (Bounding Volume Hierarchy) class
+// - binary tree of AABBs over a set of objects that do not move
+//   (e.g. level terrain), built once top-down with median splits
+// - nodes are stored in a flat array (children of node i are contiguous)
+// - rect queries can skip whole subtrees by collision category
+// - queries do not allocate and do not modify the tree (re-entrant)
+// - must be rebuilt if objects are added/removed/moved
+// - ordered raycasts visit nodes front-to-back and prune nodes beyond the
+//   current ray limit (e.g. the closest hit found so far)
+class agp::BVH
+{
+	public:
+
+		// receives an object whose rect is crossed by the ray and returns
+		// the new ray limit in [0,1] (nodes entered beyond it are pruned),
+		// or a negative value to stop the traversal
+		typedef std::function<float(Object* obj)> RayVisitor;
+
+	protected:
+
+		struct Node
+		{
+			RectF bounds;		// union of all objects rects below this node
+			int first;			// leaf: first item, inner: first child
+			int count;			// leaf: number of items, inner: 0
+			CollisionMask categories;	// union of all objects collision categories below this node
+		};
+
+		static const int LEAF_SIZE = 4;		// max objects per leaf
+		static const int MAX_DEPTH = 64;	// traversal stack size
+
+		std::vector<Node> _nodes;
+		std::vector<Object*> _items;		// objects sorted by leaf
+
+		// helper functions
+		void build(int nodeIndex, int first, int count);
+		RectF bounds(int first, int count) const;
+
+	public:
+
+		BVH() {}
+
+		// (re)builds the tree over the given objects
+		void build(const std::vector<Object*>& objects);
+		void clear();
+
+		// getters
+		bool empty() const { return _items.empty(); }
+		int size() const { return int(_items.size()); }
+
+		// appends objects whose rects overlap the given rect
+		// (candidates only: exact geometric test is up to the caller)
+		void query(const RectF& r, std::vector<Object*>& result) const;
+
+		// as above, only objects having any of the given collision categories
+		// (ANY_CATEGORY = all objects, including those without category)
+		static const CollisionMask ANY_CATEGORY = ~CollisionMask(0);
+		void query(const RectF& r, std::vector<Object*>& result, CollisionMask categories) const;
+
+		// appends objects whose rects are crossed by the given segment
+		void query(const LineF& line, std::vector<Object*>& result) const;
+
+		// visits objects whose rects are crossed by the given segment,
+		// front-to-back by node entry, until the ray limit prunes all nodes
+		void raycast(const LineF& line, const RayVisitor& visitor) const;
+};
@@ -22,8 +22,15 @@ class agp::Clipper : public RenderableObject
 {
 	public:
 
+		// type tag
+		typedef Clipper TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << CLIPPER_TYPE; }
+
 		Clipper(Scene* scene, const RectF& rect, int layer = 0)
-			: RenderableObject(scene, rect, nullptr, layer){}
+			: RenderableObject(scene, rect, nullptr, layer)
+		{
+			_typeMask |= typeBit();
+		}
 		virtual ~Clipper() {}
 
 		virtual void draw(SDL_Renderer* renderer, Transform camera) override
@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "Object.h"
+
+namespace agp
+{
+	class CollisionMatrix;
+}
+
+// CollisionMatrix class
+// - per-scene table of which collision categories may collide (default: all)
+// - combined with the per-object category/mask (see Object::setCollisionFilter):
+//   object A tests object B iff A's mask, restricted by the rows of A's
+//   categories, contains B's category
+// - symmetric by construction when set through setCollides
+class agp::CollisionMatrix
+{
+	public:
+
+		static const int CATEGORIES = 32;
+
+	protected:
+
+		CollisionMask _rows[CATEGORIES];	// row i: categories colliding with category bit i
+
+	public:
+
+		CollisionMatrix() { reset(); }
+
+		// all categories collide with each other
+		void reset()
+		{
+			for (int i = 0; i < CATEGORIES; i++)
+				_rows[i] = ~CollisionMask(0);
+		}
+
+		// enables/disables collisions between categories bits i and j
+		void setCollides(int i, int j, bool on)
+		{
+			if (on)
+			{
+				_rows[i] |= CollisionMask(1) << j;
+				_rows[j] |= CollisionMask(1) << i;
+			}
+			else
+			{
+				_rows[i] &= ~(CollisionMask(1) << j);
+				_rows[j] &= ~(CollisionMask(1) << i);
+			}
+		}
+
+		// categories colliding with any of the given categories
+		CollisionMask row(CollisionMask categories) const
+		{
+			CollisionMask result = 0;
+			for (int i = 0; categories; i++, categories >>= 1)
+				if (categories & 1)
+					result |= _rows[i];
+			return result;
+		}
+
+		// categories the object may collide with (0 = none)
+		CollisionMask filter(const Object* obj) const
+		{
+			return obj->collisionMask() & row(obj->collisionCategory());
+		}
+
+		// whether a tests collisions with b
+		bool tests(const Object* a, const Object* b) const
+		{
+			return (filter(a) & b->collisionCategory()) != 0;
+		}
+};
@@ -60,6 +60,10 @@ class agp::EditableObject : public RenderableObject
 
 	public:
 
+		// type tag
+		typedef EditableObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << EDITABLE_TYPE; }
+
 		EditableObject(Scene* scene, const RectF& rect, const std::string& name, int category, std::vector<std::string>& categories);
 		EditableObject(Scene* scene, const LineF& line, const std::string& name, int category, std::vector<std::string>& categories);
 		EditableObject(Scene* scene, const nlohmann::json& fromJson, std::vector<std::string>& categories);
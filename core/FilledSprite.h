@@ -36,4 +36,18 @@ class agp::FilledSprite : public Sprite
 			float angle = 0,
 			SDL_RendererFlip flip = SDL_FLIP_NONE,
 			bool fit = true) override;
+
+		// not made of frames: frame ignored
+		virtual void renderFrame(
+			const RectI& frame,
+			SDL_Renderer* renderer,
+			const RectF& drawRect,
+			Transform camera,
+			const Point& pixelUnitSize,
+			float angle = 0,
+			SDL_RendererFlip flip = SDL_FLIP_NONE,
+			bool fit = true) override
+		{
+			render(renderer, drawRect, camera, pixelUnitSize, angle, flip, fit);
+		}
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 // ----------------------------------------------------------------
 
 #include <algorithm>
+#include <iostream>
 #include "Game.h"
 #include "Window.h"
 #include "Scene.h"
@@ -20,21 +21,123 @@
 
 using namespace agp;
 
-Game::Game(const std::string& windowTitle, const Point& windowSize, float aspectRatio)
+Game::Game(const std::string& windowTitle, const Point& windowSize, float aspectRatio, bool headless)
+	: _threadPool(std::max(int(std::thread::hardware_concurrency()), 1))
 {
 	_aspectRatio = aspectRatio;
 	_scenesToPop = 0;
 	_running = false;
 	_reset = false;
 	_running = false;
-	_window = new Window(windowTitle, int(_aspectRatio * windowSize.x), windowSize.y);
+	_windowSize = Point(int(_aspectRatio * windowSize.x), windowSize.y);
+	_window = nullptr;
+	if (headless)
+	{
+		// events only (e.g. quit on interrupt), no video device
+		if (SDL_Init(SDL_INIT_EVENTS))
+			throw SDL_GetError();
+	}
+	else
+		_window = new Window(windowTitle, _windowSize.x, _windowSize.y);
+	updateOutputSize();
+	_headlessFrames = 0;
+	_headlessFrameTime = 1.0f / 60;
+	_turboSteps = 0;
+	_turboStepTime = 1.0f / 60;
+	_turboDuration = 0;
+	_turboRenderInterval = 1;
+	_simulatedTime = 0;
 	_currentFPS = 0;
+	_simulationThread = false;
+	_simulationRate = 120;
+	_simulating = false;
+
+	// the renderer is created with vsync, if the system allows it (otherwise
+	// capped at the display refresh rate); no window (headless): no pacing
+	_frameCap = _window ? float(_window->refreshRate()) : 60;
+	_pacing = !_window ? Pacing::UNCAPPED : (_window->vsync() ? Pacing::VSYNC : Pacing::CAPPED);
+}
+
+Point Game::outputSize()
+{
+	// cached: scenes may be built on loading threads
+	std::lock_guard<std::mutex> lock(_outputSizeMutex);
+	return _outputSize;
+}
+
+void Game::updateOutputSize()
+{
+	Point size = _windowSize;
+	if (_window)
+		SDL_GetRendererOutputSize(_window->renderer(), &size.x, &size.y);
+
+	std::lock_guard<std::mutex> lock(_outputSizeMutex);
+	_outputSize = size;
+}
+
+void Game::setPacing(Pacing pacing, float frameCap)
+{
+	_frameCap = frameCap > 0 ? frameCap : 60;
+	if (!_window)
+		return;
+
+	if (pacing == Pacing::VSYNC && !_window->setVSync(true))
+	{
+		pacing = Pacing::CAPPED;
+		_frameCap = float(_window->refreshRate());
+	}
+	else if (pacing != Pacing::VSYNC)
+		_window->setVSync(false);
+
+	_pacing = pacing;
+	_frameLimiter.reset();
+}
+
+void Game::setTurbo(int steps, float stepTime, float duration, int renderInterval)
+{
+	_turboSteps = std::max(steps, 0);
+	_turboStepTime = stepTime > 0 ? stepTime : 1.0f / 60;
+	_turboDuration = std::max(duration, 0.0f);
+	_turboRenderInterval = std::max(renderInterval, 0);
+}
+
+void Game::pace()
+{
+	if (_pacing == Pacing::CAPPED)
+		_frameLimiter.wait(1.0 / _frameCap);
 }
 
 void Game::run()
 {
 	_running = true;
 
+	if (_turboSteps)
+		runTurbo();
+	else if (!_window)
+		runHeadless();
+	else if (_simulationThread)
+		runDecoupled();
+	else
+		runLockstep();
+
+	destroy();
+}
+
+bool Game::updateScenes(float frameTime)
+{
+	bool simulated = false;
+	for (int i = int(_scenes.size()) - 1; i >= 0; i--)
+	{
+		_scenes[i]->update(frameTime);
+		simulated |= dynamic_cast<GameScene*>(_scenes[i]) != nullptr;
+		if (_scenes[i]->blocking())
+			break;
+	}
+	return simulated;
+}
+
+void Game::runLockstep()
+{
 	FPS fps;
 	Timer <float> frameTimer;
 
@@ -42,25 +145,126 @@ void Game::run()
 	{
 		processEvents();
 
-		float frameTime = frameTimer.restart();
-		for (int i = int(_scenes.size()) - 1; i >= 0; i--)
+		float frameTime = _frameSmoother.smooth(frameTimer.restart());
+		updateScenes(frameTime);
+
+		_window->render(_scenes);
+		pace();
+
+		if (fps.update(false))
+			_currentFPS = int(round(fps.lastFPS()));
+	}
+}
+
+void Game::runHeadless()
+{
+	// fixed frame time, no render, no pacing: as fast as the CPU allows
+	for (int frame = 0; _running && (!_headlessFrames || frame < _headlessFrames); frame++)
+	{
+		processEvents();
+		updateScenes(_headlessFrameTime);
+	}
+}
+
+void Game::runTurbo()
+{
+	FPS fps;
+
+	for (int iteration = 0; _running; iteration++)
+	{
+		processEvents();
+
+		// one fixed step per update: the scenes never drop nor stretch time
+		for (int i = 0; i < _turboSteps && _running; i++)
 		{
-			_scenes[i]->update(frameTime);
-			if (_scenes[i]->blocking())
-				break;
+			// only game updates count (not e.g. menus blocking the game)
+			if (updateScenes(_turboStepTime))
+				_simulatedTime += _turboStepTime;
+			if (_turboDuration && _simulatedTime >= _turboDuration)
+				_running = false;
 		}
 
-		_window->render(_scenes);
+		if (_window && _turboRenderInterval && iteration % _turboRenderInterval == 0)
+		{
+			// scenes set for snapshot rendering (simulation thread) draw the latest update
+			for (auto scene : _scenes)
+				if (scene->snapshotRendering())
+					scene->publishSnapshot();
+			_window->render(_scenes);
+		}
 
 		if (fps.update(false))
 			_currentFPS = int(round(fps.lastFPS()));
 	}
+}
 
-	destroy();
+void Game::runDecoupled()
+{
+	FPS fps;
+	std::vector<Scene*> scenes;
+
+	{
+		std::lock_guard<std::mutex> lock(_scenesMutex);
+		for (auto scene : _scenes)
+			scene->setSnapshotRendering(true);
+	}
+	_simulating = true;
+	_simulation = std::thread(&Game::simulationLoop, this);
+
+	while (_running)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_scenesMutex);
+			processEvents();
+			scenes = _scenes;
+		}
+
+		// scenes rendered from snapshots do not wait for the simulation
+		_window->render(scenes, &_scenesMutex);
+		pace();
+
+		if (fps.update(false))
+			_currentFPS = int(round(fps.lastFPS()));
+	}
+
+	_simulating = false;
+	_simulation.join();
+}
+
+void Game::simulationLoop()
+{
+	Timer <float> frameTimer;
+	FrameSmoother frameSmoother(_frameSmoother.frames());
+	auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<float>(1 / _simulationRate));
+	auto next = std::chrono::steady_clock::now();
+
+	while (_simulating)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_scenesMutex);
+
+			float frameTime = frameSmoother.smooth(frameTimer.restart());
+			updateScenes(frameTime);
+
+			for (auto scene : _scenes)
+				if (scene->snapshotRendering())
+					scene->publishSnapshot();
+		}
+
+		// fixed update rate (no catch up after stalls: the scenes do)
+		next += period;
+		auto now = std::chrono::steady_clock::now();
+		if (next < now)
+			next = now;
+		std::this_thread::sleep_until(next);
+	}
 }
 
 void Game::destroy()
 {
+	cancelSceneLoads();
+
 	for (auto scene : _scenes)
 		delete scene;
 
@@ -79,10 +283,13 @@ void Game::processEvents()
 	// if there are scenes to be deleted, better to do this after event dispatching
 	for (; _scenesToPop > 0; _scenesToPop--)
 		popScene();
+
+	swapLoadedScenes();
 	
 	if (_reset)
 	{
 		_reset = false;
+		cancelSceneLoads();
 		for (auto scene : _scenes)
 			delete scene;
 		_scenes.clear();
@@ -92,10 +299,17 @@ void Game::processEvents()
 
 void Game::dispatchEvent(SDL_Event& evt)
 {
+	// quit requests (window closed, or SIGINT/SIGTERM turned into events by SDL)
+	if (evt.type == SDL_QUIT)
+		quit();
+
 	// window events are dispatched to all scenes for their views adjustments
 	if (evt.type == SDL_WINDOWEVENT)
+	{
+		updateOutputSize();
 		for (auto& scene : _scenes)
 			scene->event(evt);
+	}
 
 	// all other events are dispatched from top to down through the scene stack
 	// if a blocking layer is encountered, event propagation stops
@@ -112,6 +326,7 @@ void Game::dispatchEvent(SDL_Event& evt)
 
 void Game::pushScene(Scene* scene)
 {
+	scene->setSnapshotRendering(_simulating);
 	_scenes.push_back(scene);
 }
 
@@ -122,4 +337,48 @@ void Game::popScene()
 		delete _scenes.back();
 		_scenes.pop_back();
 	}
+}
+
+void Game::pushSceneAsync(const std::function<Scene*()>& loader, Scene* placeholder)
+{
+	pushScene(placeholder);
+	_sceneLoads.push_back({ placeholder, std::async(std::launch::async, loader) });
+}
+
+void Game::swapLoadedScenes()
+{
+	for (int i = int(_sceneLoads.size()) - 1; i >= 0; i--)
+	{
+		std::future<Scene*>& future = _sceneLoads[i].scene;
+		if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			continue;
+
+		Scene* scene = future.get();
+		auto placeholder = std::find(_scenes.begin(), _scenes.end(), _sceneLoads[i].placeholder);
+		if (placeholder == _scenes.end())
+			delete scene;		// placeholder already popped: nobody waits for this scene
+		else
+		{
+			delete *placeholder;
+			if (scene)
+			{
+				scene->setSnapshotRendering(_simulating);
+				*placeholder = scene;
+			}
+			else
+			{
+				std::cerr << "Cannot load scene: loader returned nothing\n";
+				_scenes.erase(placeholder);
+			}
+		}
+		_sceneLoads.erase(_sceneLoads.begin() + i);
+	}
+}
+
+void Game::cancelSceneLoads()
+{
+	// loaders cannot be interrupted: wait for them and discard their scenes
+	for (auto& load : _sceneLoads)
+		delete load.scene.get();
+	_sceneLoads.clear();
 }
\ No newline at end of file
@@ -9,8 +9,15 @@
 
 #pragma once
 #include "geometryUtils.h"
+#include "timeUtils.h"
 #include "Singleton.h"
+#include "ThreadPool.h"
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <functional>
 
 namespace agp
 {
@@ -24,6 +31,18 @@ namespace agp
 // - contains the scenes stack
 // - receives and dispatches events throughout scene stack
 // - singleton access
+// - optionally headless (no window, no renderer): scenes are updated with
+//   a fixed frame time as fast as possible (batch runs, benchmarks)
+// - optionally in turbo mode: K fixed steps per loop iteration, not tied
+//   to the wall clock, possibly for a given simulated time only, with
+//   rendering decimated or skipped (soak tests, self-play, long repros)
+// - optionally runs the simulation on its own thread: scenes supporting
+//   it are drawn from the snapshots published at every update, the others
+//   are drawn under the scenes lock (events are dispatched under the lock
+//   too, and applied at the next update)
+// - scenes can be built on a background thread while a placeholder scene
+//   is shown, and are swapped in between frames when ready
+// - owns the worker threads shared by the scenes (see ThreadPool)
 class agp::Game : public Singleton<Game>
 { 
 	friend class Singleton<Game>;
@@ -32,35 +51,128 @@ class agp::Game : public Singleton<Game>
 
 		//typedef std::set< Scene*> SceneSet;
 
+		// frame pacing modes
+		// - VSYNC: presents wait for the display refresh
+		// - UNCAPPED: no wait at all (benchmarking: true throughput)
+		// - CAPPED: at most frameCap frames per second (sleep, then spin)
+		enum class Pacing { VSYNC, UNCAPPED, CAPPED };
+
 	protected:
 
 		// attributes
-		Window* _window;
+		Window* _window;					// nullptr if headless
+		Point _windowSize;					// requested window size
+		Point _outputSize;					// cached renderer output size (any thread)
+		std::mutex _outputSizeMutex;
 		float _aspectRatio;					// -1 if free to vary
 		std::vector<Scene*> _scenes;		// scenes stack
 		int _scenesToPop;					// for popSceneLater
-		bool _running;
+		std::atomic<bool> _running;
 		bool _reset;
-		int _currentFPS;
+		std::atomic<int> _currentFPS;
+
+		// frame pacing
+		Pacing _pacing;
+		float _frameCap;					// frames per second (CAPPED)
+		FrameLimiter _frameLimiter;
+		FrameSmoother _frameSmoother;		// frame deltas fed to the scenes
+
+		// headless run
+		int _headlessFrames;				// frames to run (0 = until quit)
+		float _headlessFrameTime;			// time simulated per frame
+
+		// turbo mode
+		int _turboSteps;					// fixed steps per loop iteration (0 = off)
+		float _turboStepTime;				// time simulated per step
+		float _turboDuration;				// simulated seconds to run (0 = until quit)
+		int _turboRenderInterval;			// render every N iterations (0 = never)
+		double _simulatedTime;				// simulated seconds so far (turbo)
+
+		// simulation thread
+		bool _simulationThread;				// if true, simulation runs on its own thread
+		float _simulationRate;				// scene updates per second (simulation thread)
+		std::thread _simulation;
+		std::atomic<bool> _simulating;
+		std::mutex _scenesMutex;			// scenes stack and scenes state
+
+		// worker threads
+		ThreadPool _threadPool;				// shared by the scenes (step jobs, parallel loops)
+
+		// asynchronous scene loading
+		struct SceneLoad
+		{
+			Scene* placeholder;				// replaced by the loaded scene
+			std::future<Scene*> scene;
+		};
+		std::vector<SceneLoad> _sceneLoads;
 
 		// helper functions
 		virtual void destroy();
 		virtual void processEvents();
+		virtual void updateOutputSize();
+		virtual void swapLoadedScenes();
+		virtual void cancelSceneLoads();
+		virtual bool updateScenes(float frameTime);	// true if a GameScene was updated
+		virtual void pace();
+		virtual void runLockstep();
+		virtual void runHeadless();
+		virtual void runTurbo();
+		virtual void runDecoupled();
+		virtual void simulationLoop();
 
 	public: 
 		
-		Game(const std::string& windowTitle = "Game", const Point& windowSize = { 600,600 }, float aspectRatio = -1);
+		Game(const std::string& windowTitle = "Game", const Point& windowSize = { 600,600 }, float aspectRatio = -1, bool headless = false);
 
 		// getters
 		Window* window() { return _window; }
+		bool headless() const { return _window == nullptr; }
+		Point outputSize();					// renderer output size (headless: requested window size)
 		float aspectRatio() { return _aspectRatio; }
 		int currentFPS() { return _currentFPS; }
 
+		// frame pacing settings (main thread)
+		// - VSYNC falls back to CAPPED at the display refresh rate if vsync is not available
+		// - smoothing: frame deltas averaged over the given frames (1 = raw deltas)
+		Pacing pacing() const { return _pacing; }
+		void setPacing(Pacing pacing, float frameCap = 60);
+		float frameCap() const { return _frameCap; }
+		void setFrameSmoothing(int frames) { _frameSmoother.setFrames(frames); }
+
+		// headless run settings (before run)
+		void setHeadlessRun(int frames, float frameTime = 1.0f / 60) { _headlessFrames = frames; _headlessFrameTime = frameTime; }
+
+		// turbo mode settings (before run)
+		// - steps: fixed updates of stepTime per loop iteration (0 = off), no pacing
+		// - duration: simulated seconds after which the game is over (0 = until quit),
+		//   counting only the steps that update a GameScene
+		// - renderInterval: render every N iterations (0 = never), vsync still waits
+		// - takes precedence over the simulation thread and the headless run
+		bool turbo() const { return _turboSteps > 0; }
+		void setTurbo(int steps, float stepTime = 1.0f / 60, float duration = 0, int renderInterval = 1);
+		double simulatedTime() const { return _simulatedTime; }
+
+		// worker threads shared by the scenes (default: one per hardware thread)
+		ThreadPool& threadPool() { return _threadPool; }
+
+		// simulation thread settings (before run)
+		bool simulationThread() const { return _simulationThread; }
+		void setSimulationThread(bool on) { _simulationThread = on; }
+		float simulationRate() const { return _simulationRate; }
+		void setSimulationRate(float updatesPerSecond) { _simulationRate = updatesPerSecond; }
+
 		// scene stack access
 		void pushScene(Scene* scene);
 		void popScene();
 		void popSceneLater() { _scenesToPop++; }
 
+		// pushes the placeholder and builds a scene on a background thread: when
+		// done, the scene replaces the placeholder (deleted) between frames
+		// - loader must not use the renderer (textures must already exist)
+		// - loader returning nullptr: the placeholder is popped
+		void pushSceneAsync(const std::function<Scene*()>& loader, Scene* placeholder);
+		bool loading() const { return !_sceneLoads.empty(); }
+
 		// event dispatcher
 		virtual void dispatchEvent(SDL_Event& evt);
 
@@ -15,14 +15,38 @@
 #include "OverlayScene.h"
 #include "EditorScene.h"
 #include "EditorUI.h"
+#include <algorithm>
 
 using namespace agp;
 
+// sorts query results as Scene does: by ascending z-level, then by creation order
+static bool paintersOrder(Object* a, Object* b)
+{
+	return a->layer() != b->layer() ? a->layer() < b->layer() : a->id() < b->id();
+}
+
+// rect enlarged by the given margin on each side
+static RectF inflated(const RectF& r, float margin)
+{
+	return RectF(r.pos.x - margin, r.pos.y - margin, r.size.x + 2 * margin, r.size.y + 2 * margin, r.yUp);
+}
+
 GameScene::GameScene(const RectF& rect, const Point& pixelUnitSize, float dt)
-	: Scene(rect, pixelUnitSize)
+	: Scene(rect, pixelUnitSize), _grid(rect), _threadPool(Game::instance()->threadPool()), _triggers(rect)
 {
 	_dt = dt;
 	_timeToSimulateAccum = 0;
+	_maxStepsPerFrame = 5;
+	_interpolation = true;
+	_interpolationAlpha = 1;
+	_staticTreeDirty = false;
+	_activationEnabled = false;
+	_activationMargin = 4;
+	_activationHysteresis = 2;
+	_sleepTickDivider = 0;
+	_stepCount = 0;
+	_queryEpoch = 1;
+	_parallelMinObjects = 32;
 	_player = nullptr;
 	_cameraZoomVel = 0.1f;
 	_cameraTranslateVel = { 500, 500 };
@@ -35,11 +59,427 @@ GameScene::GameScene(const RectF& rect, const Point& pixelUnitSize, float dt)
 	float ar = Game::instance()->aspectRatio();
 	if(ar)
 		_view->setFixedAspectRatio(ar);
+
+	buildStepJobs();
+}
+
+void GameScene::buildStepJobs()
+{
+	// interpolation state and activation are independent, integration needs
+	// the awake objects, broadphase the integrated velocities, predictions
+	// the broadphase pairs (serial pool: same order as listed)
+	int interpolation = _stepJobs.add([this]() { captureInterpolation(); });
+	int activation = _stepJobs.add([this]() { updateActivation(); });
+	int integration = _stepJobs.add([this]() { _physics.update(_dt, &_threadPool); }, { activation });
+	int broadphase = _stepJobs.add([this]() { _broadphase.update(_dt, _collisionMatrix); }, { integration });
+	_stepJobs.add([this]() { predictContacts(); }, { broadphase, interpolation });
+}
+
+void GameScene::captureInterpolation()
+{
+	for (auto& layer : _sortedObjects)
+		for (auto& obj : layer.objects)
+			obj->_prevPos = obj->_rect.pos;
+}
+
+void GameScene::setPlayer(Object* player)
+{
+	_player = player;
+	if (player)
+	{
+		player->setAlwaysAwake(true);
+		_triggers.watch(player);
+	}
+}
+
+void GameScene::setGridCellSize(float cellSize)
+{
+	_grid.reset(_rect, cellSize);
+	for (auto& layer : _sortedObjects)
+		for (auto& obj : layer.objects)
+			if (!obj->isStatic())
+				_grid.add(obj);
+}
+
+void GameScene::objectAdded(Object* obj)
+{
+	_queryEpoch++;
+	if (obj->isStatic())
+	{
+		_staticObjects.push_back(obj);
+		_staticTreeDirty = true;
+	}
+	else
+	{
+		_grid.add(obj);
+		_broadphase.add(obj);
+	}
+
+	if (obj->batchPhysics() && !obj->isStatic())
+		_physics.add(obj);
+
+	// new objects are awake: those far from the camera sleep from the next step
+	if (obj->_awake)
+		_awakeObjects.push_back(obj);
+}
+
+void GameScene::objectRemoved(Object* obj)
+{
+	_queryEpoch++;
+	if (obj->isStatic())
+	{
+		auto it = std::find(_staticObjects.begin(), _staticObjects.end(), obj);
+		if (it != _staticObjects.end())
+			_staticObjects.erase(it);
+		_staticTreeDirty = true;
+	}
+	else
+	{
+		_grid.remove(obj);
+		_broadphase.remove(obj);
+	}
+
+	_physics.remove(obj);
+	_triggers.unwatch(obj);
+
+	auto lastCarry = std::remove_if(_carries.begin(), _carries.end(),
+		[obj](const Carry& c) { return c.platform == obj || c.rider == obj; });
+	_carries.erase(lastCarry, _carries.end());
+
+	if (obj->_awake)
+	{
+		auto it = std::find(_awakeObjects.begin(), _awakeObjects.end(), obj);
+		if (it != _awakeObjects.end())
+			_awakeObjects.erase(it);
+	}
+}
+
+void GameScene::objectMoved(Object* obj)
+{
+	// static objects: see invalidateStaticIndex
+	// objects not indexed yet: binned when added
+	if (obj->isStatic() || (!obj->_gridCells.isValid() && !obj->_gridOversized))
+		return;
+
+	// teleports and resizes are rare: full re-binning (may change oversized state)
+	_grid.remove(obj);
+	_grid.add(obj);
+	_queryEpoch++;
+}
+
+void GameScene::setActivationEnabled(bool on)
+{
+	_activationEnabled = on;
+
+	// wake up everybody: sleeping objects will be found again by updateActivation
+	if (!on)
+		for (auto& layer : _sortedObjects)
+			for (auto& obj : layer.objects)
+				if (!obj->_awake)
+				{
+					obj->_awake = true;
+					_awakeObjects.push_back(obj);
+				}
+}
+
+void GameScene::updateActivation()
+{
+	if (!_activationEnabled)
+		return;
+
+	refreshStaticTree();
+	RectF wakeRect = inflated(_view->rect(), _activationMargin);
+	RectF sleepRect = inflated(_view->rect(), _activationMargin + _activationHysteresis);
+
+	// put to sleep awake objects beyond the sleep rect (hysteresis avoids
+	// flickering of objects moving along the activation border)
+	auto last = std::remove_if(_awakeObjects.begin(), _awakeObjects.end(),
+		[&sleepRect](Object* obj) {
+			bool sleep = !obj->_alwaysAwake && !obj->intersectsRectShallow(sleepRect);
+			if (sleep)
+				obj->_awake = false;
+			return sleep;
+		});
+	_awakeObjects.erase(last, _awakeObjects.end());
+
+	// wake up sleeping objects within the wake rect (cost ~ objects near the camera)
+	_activationBuffer.clear();
+	_grid.query(wakeRect, _activationBuffer);
+	_staticTree.query(wakeRect, _activationBuffer);
+	for (auto obj : _activationBuffer)
+		if (!obj->_awake && obj->intersectsRectShallow(wakeRect))
+		{
+			obj->_awake = true;
+			_awakeObjects.push_back(obj);
+		}
+}
+
+void GameScene::tick(Object* obj)
+{
+	// killed objects still need to tick to be deallocated
+	if (obj->_awake || obj->_alwaysAwake || obj->_killed)
+		obj->update(_dt);
+
+	// sleeping objects: one tick every n steps, staggered by id to spread the load
+	else if (_sleepTickDivider && (_stepCount + unsigned(obj->id())) % unsigned(_sleepTickDivider) == 0)
+		obj->update(_dt * _sleepTickDivider);
+	else
+		return;
+
+	_grid.update(obj);		// keeps queries of next objects exact
+}
+
+void GameScene::predictContacts()
+{
+	// objects that will tick at full rate in this step and have broadphase
+	// partners (their candidate queries do not touch the query marks)
+	_predicted.clear();
+	for (auto& layer : _sortedObjects)
+		for (auto& obj : layer.objects)
+			if (!obj->_freezed && !obj->_killed && (obj->_awake || obj->_alwaysAwake) && obj->_broadphaseIndex >= 0)
+				_predicted.push_back(obj);
+
+	// serial: prediction would just anticipate the same work
+	if (_threadPool.threads() == 1 || int(_predicted.size()) < _parallelMinObjects)
+		return;
+
+	// no static index rebuild during the parallel phase
+	refreshStaticTree();
+
+	_threadPool.parallelFor(int(_predicted.size()), 8, [this](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+				_predicted[i]->predictContacts(_dt);
+		});
+}
+
+void GameScene::addCarry(Object* platform, Object* rider, const Vec2Df& displacement)
+{
+	for (auto& carry : _carries)
+		if (carry.rider == rider)
+			return;
+
+	_carries.push_back({ platform, rider, displacement, 0 });
+}
+
+void GameScene::carryPhase()
+{
+	// dependency order: riders of a carried platform after the platform
+	// (depth capped to the number of carries, robust to cycles)
+	int n = int(_carries.size());
+	for (auto& carry : _carries)
+	{
+		Object* platform = carry.platform;
+		for (carry.depth = 0; carry.depth < n; carry.depth++)
+		{
+			auto below = std::find_if(_carries.begin(), _carries.end(),
+				[platform](const Carry& c) { return c.rider == platform; });
+			if (below == _carries.end())
+				break;
+			platform = below->platform;
+		}
+	}
+	std::stable_sort(_carries.begin(), _carries.end(),
+		[](const Carry& a, const Carry& b) { return a.depth < b.depth; });
+
+	for (int i = 0; i < n; i++)
+	{
+		Carry& carry = _carries[i];
+
+		// platform carried in turn: its riders move with it
+		for (int j = 0; j < i; j++)
+			if (_carries[j].rider == carry.platform)
+				carry.displacement += _carries[j].displacement;
+
+		// actual rider displacement (rider may stop against something)
+		if (!carry.rider->_killed)
+		{
+			PointF startPos = carry.rider->_rect.pos;
+			carry.rider->carriedBy(carry.platform, carry.displacement);
+			carry.displacement = carry.rider->_rect.pos - startPos;
+			_grid.update(carry.rider);		// moved after its own tick
+		}
+		else
+			carry.displacement = Vec2Df(0, 0);
+	}
+	_carries.clear();
+}
+
+void GameScene::refreshStaticTree()
+{
+	if (_staticTreeDirty)
+	{
+		_staticTree.build(_staticObjects);
+		_staticTreeDirty = false;
+	}
+}
+
+void GameScene::objects(const RectF& cullingRect, ObjectsVector& result, const QueryFilter& filter)
+{
+	refreshStaticTree();
+
+	result.clear();
+	_grid.query(cullingRect, result);
+	_staticTree.query(cullingRect, result);
+
+	auto last = std::remove_if(result.begin(), result.end(),
+		[&cullingRect, &filter](Object* obj) { return !filter.accepts(obj) || !obj->intersectsRectShallow(cullingRect); });
+	result.erase(last, result.end());
+	std::sort(result.begin(), result.end(), paintersOrder);
+}
+
+void GameScene::objects(const PointF& containPoint, ObjectsVector& result, const QueryFilter& filter)
+{
+	refreshStaticTree();
+
+	result.clear();
+	_grid.query(containPoint, result);
+	_staticTree.query(RectF(containPoint.x, containPoint.y, 0, 0), result);
+
+	auto last = std::remove_if(result.begin(), result.end(),
+		[&containPoint, &filter](Object* obj) { return !filter.accepts(obj) || !obj->contains(containPoint); });
+	result.erase(last, result.end());
+	std::sort(result.begin(), result.end(), paintersOrder);
+}
+
+void GameScene::collisionCandidates(Object* obj, const RectF& rect, std::vector<Object*>& result, TypeMask typeMask)
+{
+	// categories tested by obj: none = no narrowphase work at all
+	CollisionMask mask = _collisionMatrix.filter(obj);
+	if (!mask)
+		return;
+
+	refreshStaticTree();
+
+	size_t first = result.size();
+	if (!_broadphase.candidates(obj, result))
+		_grid.query(rect, result);
+	_staticTree.query(rect, result, mask);
+
+	auto last = std::remove_if(result.begin() + first, result.end(),
+		[obj, &rect, typeMask, mask](Object* item) {
+			return item == obj || !(item->collisionCategory() & mask) ||
+				(typeMask && !(item->typeMask() & typeMask)) || !item->intersectsRectShallow(rect); });
+	result.erase(last, result.end());
+	std::sort(result.begin() + first, result.end(), paintersOrder);
+}
+
+bool GameScene::stepCandidates(Object* obj, const RectF& reach, std::vector<Object*>& result, TypeMask typeMask)
+{
+	CollisionMask mask = _collisionMatrix.filter(obj);
+	size_t first = result.size();
+	if (!mask || !_broadphase.candidates(obj, result))
+		return false;
+
+	refreshStaticTree();
+	_staticTree.query(reach, result, mask);
+
+	// same filters of collisionCandidates, except rect (see candidatesWithin)
+	auto last = std::remove_if(result.begin() + first, result.end(),
+		[obj, typeMask, mask](Object* item) {
+			return item == obj || !(item->collisionCategory() & mask) ||
+				(typeMask && !(item->typeMask() & typeMask)); });
+	result.erase(last, result.end());
+	std::sort(result.begin() + first, result.end(), paintersOrder);
+	return true;
+}
+
+void GameScene::candidatesWithin(Object* obj, const RectF& rect, const std::vector<Object*>& superset, std::vector<Object*>& result, TypeMask typeMask)
+{
+	// filters are applied again: categories and types may have changed in the step
+	// (superset is sorted, hence the result too)
+	CollisionMask mask = _collisionMatrix.filter(obj);
+	if (!mask)
+		return;
+
+	for (auto item : superset)
+		if ((item->collisionCategory() & mask) && (!typeMask || (item->typeMask() & typeMask)) &&
+			item->intersectsRectShallow(rect))
+			result.push_back(item);
+}
+
+void GameScene::raycast(const LineF& line, ObjectsVector& result, const QueryFilter& filter, RaycastMode mode, int maxHits)
+{
+	refreshStaticTree();
+
+	// hits are kept sorted (by ray parameter, then creation order) and
+	// truncated to the requested number, except in ALL mode (sorted at the end)
+	size_t hitsMax = mode == RaycastMode::ALL ? _raycastHits.max_size() :
+		mode == RaycastMode::ANY ? 1 : size_t(std::max(maxHits, 0));
+	auto nearer = [](const std::pair<Object*, float>& a, const std::pair<Object*, float>& b) {
+		return a.second != b.second ? a.second < b.second : a.first->id() < b.first->id();
+	};
+	auto test = [&](Object* obj)
+	{
+		float tNear;
+		if (!filter.accepts(obj) || !obj->intersectsLine(line, tNear))
+			return;
+		std::pair<Object*, float> hit(obj, tNear);
+		if (mode == RaycastMode::ALL)
+			_raycastHits.push_back(hit);
+		else
+		{
+			_raycastHits.insert(std::upper_bound(_raycastHits.begin(), _raycastHits.end(), hit, nearer), hit);
+			if (_raycastHits.size() > hitsMax)
+				_raycastHits.pop_back();
+		}
+	};
+	auto done = [&]()
+	{
+		return mode == RaycastMode::ANY ? !_raycastHits.empty() :
+			mode == RaycastMode::CLOSEST && _raycastHits.size() >= hitsMax;
+	};
+
+	_raycastHits.clear();
+	result.clear();
+	if (hitsMax == 0)
+		return;
+
+	// static objects: BVH nodes front-to-back, pruned beyond the farthest kept hit
+	_staticTree.raycast(line, [&](Object* obj)
+		{
+			test(obj);
+			if (mode == RaycastMode::ANY && done())
+				return -1.0f;
+			return done() ? _raycastHits.back().second : 1.0f;
+		});
+
+	// moving objects: grid cells in ray order, until no later cell can contain a nearer hit
+	if (!(mode == RaycastMode::ANY && done()))
+	{
+		bool walked = _grid.raycast(line, [&](const std::vector<Object*>& objects, float tEnter, float tExit)
+			{
+				for (auto obj : objects)
+				{
+					test(obj);
+					if (mode == RaycastMode::ANY && done())
+						return false;
+				}
+				return !(done() && _raycastHits.back().second < tExit);
+			});
+
+		// line out of the grid: moving objects under the line bounding rect
+		if (!walked)
+		{
+			_grid.query(line.boundingRect(_rect.yUp), result);
+			for (auto obj : result)
+				test(obj);
+		}
+	}
+
+	if (mode == RaycastMode::ALL)
+		std::sort(_raycastHits.begin(), _raycastHits.end(), nearer);
+
+	result.clear();
+	for (const auto& hit : _raycastHits)
+		result.push_back(hit.first);
 }
 
 void GameScene::render()
 {
-	if (_active)
+	if (_snapshotRendering)
+		renderSnapshot();
+	else if (_active)
 	{
 		if (!_displayGameSceneOnly)
 			for (auto& bgScene : _backgroundScenes)
@@ -53,6 +493,43 @@ void GameScene::render()
 	}
 }
 
+void GameScene::captureSnapshot(RenderSnapshot& snapshot)
+{
+	snapshot.visible = _active;
+	if (!_active)
+		return;
+
+	_view->capture(snapshot);
+	snapshot.dt = _interpolation ? _dt : 0;
+	snapshot.viewStep = _cameraStep;
+}
+
+void GameScene::publishSnapshot()
+{
+	for (auto& bgScene : _backgroundScenes)
+		bgScene->publishSnapshot();
+	Scene::publishSnapshot();
+	for (auto& fgScene : _foregroundScenes)
+		fgScene->publishSnapshot();
+}
+
+void GameScene::renderSnapshot()
+{
+	const RenderSnapshot* snapshot = _snapshots.latest();
+	if (!snapshot || !snapshot->visible)
+		return;
+
+	if (!_displayGameSceneOnly)
+		for (auto& bgScene : _backgroundScenes)
+			bgScene->renderSnapshot();
+
+	_view->render(*snapshot);
+
+	if (!_displayGameSceneOnly)
+		for (auto& fgScene : _foregroundScenes)
+			fgScene->renderSnapshot();
+}
+
 void GameScene::update(float timeToSimulate)
 {
 	Scene::update(timeToSimulate);
@@ -82,17 +559,41 @@ void GameScene::updateControls(float timeToSimulate)
 
 void GameScene::updateWorld(float timeToSimulate)
 {
-	// semi-fixed timestep
+	// fixed timestep, at most _maxStepsPerFrame steps per frame: on slow
+	// frames the game slows down instead of running ever more steps to
+	// catch up (spiral of death)
 	_timeToSimulateAccum += timeToSimulate;
-	while (_timeToSimulateAccum >= _dt)
+	for (int steps = 0; _timeToSimulateAccum >= _dt && steps < _maxStepsPerFrame; steps++)
 	{
+		// step jobs (see buildStepJobs):
+		// - previous state for render interpolation
+		// - wake up/put to sleep objects according to the camera position
+		// - batch velocity integration of opt-in (awake) bodies
+		// - broadphase: candidate collision pairs for this step
+		// - narrowphase of the objects ticking at full rate in parallel (read-only)
+		_threadPool.run(_stepJobs);
+
+		// sync point: objects update serially (collision resolution)
 		for (auto& layer : _sortedObjects)
-			for (auto& obj : layer.second)
+			for (auto& obj : layer.objects)
 				if (!obj->freezed())
-					obj->update(_dt);		// physics, collision, logic, animation
+					tick(obj);		// physics, collision, logic, animation
+
+		// riders move along with their platforms (re-binned there)
+		carryPhase();
+
+		// trigger volumes enter/stay/exit events
+		_triggers.update();
 
 		_timeToSimulateAccum -= _dt;
+		_stepCount++;
+		_queryEpoch++;
 	}
+	if (_timeToSimulateAccum >= _dt)
+		_timeToSimulateAccum = std::fmod(_timeToSimulateAccum, _dt);
+
+	// objects are drawn between the last two steps by the leftover fraction
+	_interpolationAlpha = _interpolation ? _timeToSimulateAccum / _dt : 1;
 }
 
 void GameScene::updateCamera(float timeToSimulate)
@@ -111,6 +612,7 @@ void GameScene::updateCamera(float timeToSimulate)
 	if (keyboard[SDL_SCANCODE_DOWN] && !keyboard[SDL_SCANCODE_UP])
 		yDir = Direction::DOWN;
 
+	_cameraStep = Vec2Df();
 	if (_cameraManual)
 	{
 		_view->move((_cameraTranslateVel / _view->magf()) * dir2vec(xDir, _rect.yUp) * timeToSimulate);
@@ -118,8 +620,11 @@ void GameScene::updateCamera(float timeToSimulate)
 	}
 	else if(_cameraFollowsPlayer)
 	{
-		_view->setX(_player->rect().pos.x - _view->rect().size.x / 2);
-		_view->setY(_player->rect().pos.y - _view->rect().size.y / 2);
+		// same (interpolated) pos the player is drawn at
+		PointF playerPos = _player->interpolatedPos(_interpolationAlpha);
+		_view->setX(playerPos.x - _view->rect().size.x / 2);
+		_view->setY(playerPos.y - _view->rect().size.y / 2);
+		_cameraStep = _player->rect().pos - _player->_prevPos;
 	}
 }
 
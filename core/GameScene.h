@@ -9,6 +9,12 @@
 
 #pragma once
 #include "Scene.h"
+#include "SpatialGrid.h"
+#include "BVH.h"
+#include "SweepAndPrune.h"
+#include "PhysicsStore.h"
+#include "ThreadPool.h"
+#include "TriggerSystem.h"
 #include "graphicsUtils.h"
 
 namespace agp
@@ -19,8 +25,30 @@ namespace agp
 }
 
 // GameScene (or World) class
-// - specialized update(dt) to semifixed timestep
-// - may provide more efficient access to game objects (e.g. quadtree)
+// - specialized update(dt) to fixed timestep, with a max number of steps
+//   per frame and render interpolation of objects between the last two steps
+// - provides efficient access to game objects (uniform grid for moving
+//   objects, BVH built once for static objects)
+// - runs a sweep-and-prune collision broadphase at every step
+// - filters collisions by category/mask and collision matrix before the
+//   narrowphase (whole categories are skipped by broadphase and BVH)
+// - integrates opt-in bodies in batch (structure-of-arrays) at every step,
+//   in parallel chunks of bodies
+// - runs the per-step work that only touches per-object state as a graph
+//   of jobs on a work-stealing pool, with a sync point before the objects
+//   update (collision resolution is serial)
+// - predicts collisions of the objects in parallel before they update
+//   (read-only), then updates them serially: predictions are used only if
+//   their inputs did not change, hence results match the serial path
+// - keeps trigger volumes in their own index, tested against watchers only
+// - moves riders along with their platforms in a carry phase at the end
+//   of every step, in dependency order (platforms on platforms)
+// - optionally (off by default) simulates at full rate only the objects
+//   near the camera (activation rect = view rect + margin); the others are
+//   put to sleep (suspended or ticked at a reduced rate), are static for
+//   the broadphase and wake when the camera approaches
+// - raycasts walk grid cells (DDA) and BVH nodes in ray order, and stop
+//   as soon as the requested hits are found
 // - can/should be subclassed for the specific game to implement 
 // - stores the main player and implements basic controls
 class agp::GameScene : public Scene
@@ -30,6 +58,49 @@ class agp::GameScene : public Scene
 		// basic physics/integration
 		float _dt;					// time integration step
 		float _timeToSimulateAccum;	// time to simulate (accumulator)
+		int _maxStepsPerFrame;		// above, time to simulate is dropped (spiral of death guard)
+		bool _interpolation;		// if true, objects are drawn between the last two steps
+		float _interpolationAlpha;	// leftover accumulator fraction of a step
+
+		// spatial indexing
+		SpatialGrid _grid;			// uniform grid of moving objects
+		BVH _staticTree;			// hierarchy of static objects
+		std::vector<Object*> _staticObjects;	// objects indexed by _staticTree
+		bool _staticTreeDirty;		// if true, _staticTree is rebuilt at next query
+		SweepAndPrune _broadphase;	// candidate pairs of moving objects
+		CollisionMatrix _collisionMatrix;	// which collision categories collide
+
+		// batch physics
+		PhysicsStore _physics;		// SoA state of moving bodies
+
+		// per-step jobs before the objects update (work-stealing)
+		ThreadPool& _threadPool;	// workers of the step jobs and parallel loops (see Game)
+		ThreadPool::TaskGraph _stepJobs;	// interpolation, activation, integration, broadphase, prediction
+		int _parallelMinObjects;	// below, no prediction phase (not worth the dispatch)
+		std::vector<Object*> _predicted;	// objects predicted in the current step
+
+		// trigger volumes
+		TriggerSystem _triggers;	// tested against watchers at the end of every step
+
+		// platform carry
+		struct Carry
+		{
+			Object* platform;
+			Object* rider;
+			Vec2Df displacement;	// platform displacement (after carry: rider displacement)
+			int depth;				// carried platforms below (dependency order)
+		};
+		std::vector<Carry> _carries;	// carries of the current step (reused)
+
+		// simulation activation
+		bool _activationEnabled;	// if false, all objects are always awake
+		float _activationMargin;	// wake margin around the view rect (scene units)
+		float _activationHysteresis;// additional margin before going back to sleep
+		int _sleepTickDivider;		// sleeping objects tick every n steps (0 = suspended)
+		unsigned int _stepCount;	// simulation steps so far (staggers sleeping ticks)
+		unsigned int _queryEpoch;	// changes with every step and indexed objects change
+		std::vector<Object*> _awakeObjects;		// objects awake, except always awake ones
+		std::vector<Object*> _activationBuffer;	// reused by updateActivation
 
 		// basic player controls
 		Object* _player;
@@ -45,8 +116,21 @@ class agp::GameScene : public Scene
 		// camera controls
 		Vec2Df _cameraTranslateVel;
 		float _cameraZoomVel;		// camera zoom velocity (in [0,1] relative scale units)
+		Vec2Df _cameraStep;			// camera displacement over the last step (follow cam)
+
+		// extends indexing hooks (+spatial grid, +static BVH, +broadphase, +physics store, +activation)
+		virtual void objectAdded(Object* obj) override;
+		virtual void objectRemoved(Object* obj) override;
+		virtual void objectMoved(Object* obj) override;
 
 		// helper functions
+		void refreshStaticTree();
+		void buildStepJobs();
+		void captureInterpolation();
+		virtual void updateActivation();
+		void tick(Object* obj);
+		virtual void carryPhase();
+		virtual void predictContacts();
 		virtual void updateOverlayScenes(float timeToSimulate);
 		virtual void updateControls(float timeToSimulate);
 		virtual void updateWorld(float timeToSimulate);
@@ -58,7 +142,7 @@ class agp::GameScene : public Scene
 		virtual ~GameScene() {};
 
 		Object* player() { return _player; }
-		virtual void setPlayer(Object* player) { _player = player; }
+		virtual void setPlayer(Object* player);
 		bool collidersVisible() const { return _collidersVisible; }
 		virtual void toggleColliders() { _collidersVisible = !_collidersVisible; }
 		virtual void toggleCameraManual() {	_cameraManual = !_cameraManual;	}
@@ -67,12 +151,80 @@ class agp::GameScene : public Scene
 		virtual void addForegroundScene(OverlayScene* fgScene) { _foregroundScenes.push_back(fgScene); }
 		virtual void displayGameSceneOnly(bool on) { _displayGameSceneOnly = on; }
 
-		// overrides scene object selection (+octree or +BVH, NOT implemented)
-		//virtual std::list<Object*> objects(const RectF& cullingRect) override;
+		// fixed timestep settings
+		float timestep() const { return _dt; }
+		void setTimestep(float dt) { _dt = dt; }
+		int maxStepsPerFrame() const { return _maxStepsPerFrame; }
+		void setMaxStepsPerFrame(int n) { _maxStepsPerFrame = std::max(n, 1); }
+		bool interpolation() const { return _interpolation; }
+		void setInterpolation(bool on) { _interpolation = on; }
+		virtual float interpolationAlpha() const override { return _interpolationAlpha; }
+
+		// spatial grid settings
+		float gridCellSize() const { return _grid.cellSize(); }
+		void setGridCellSize(float cellSize);
+
+		// simulation activation settings (default: disabled)
+		bool activationEnabled() const { return _activationEnabled; }
+		void setActivationEnabled(bool on);
+		float activationMargin() const { return _activationMargin; }
+		void setActivationMargin(float margin, float hysteresis) { _activationMargin = margin; _activationHysteresis = hysteresis; }
+		int sleepTickDivider() const { return _sleepTickDivider; }
+		void setSleepTickDivider(int n) { _sleepTickDivider = std::max(n, 0); }
+
+		// parallel step jobs settings (threads: see Game::threadPool)
+		void setParallelMinObjects(int n) { _parallelMinObjects = n; }
+
+		// moves rider by the platform displacement at the end of the step,
+		// after all objects have been updated (platforms on platforms: riders
+		// are also moved by the carry of their platform)
+		// NOTE: one carry per rider and step (the first one)
+		void addCarry(Object* platform, Object* rider, const Vec2Df& displacement);
+
+		// static objects index must be rebuilt if static geometry changes
+		void invalidateStaticIndex() { _staticTreeDirty = true; _queryEpoch++; }
+
+		// overrides scene object selection (+uniform grid, +static BVH)
+		using Scene::objects;
+		using Scene::raycast;
+		virtual void objects(const RectF& cullingRect, ObjectsVector& result, const QueryFilter& filter = QueryFilter()) override;
+		virtual void objects(const PointF& containPoint, ObjectsVector& result, const QueryFilter& filter = QueryFilter()) override;
+		virtual void raycast(const LineF& line, ObjectsVector& result, const QueryFilter& filter = QueryFilter(),
+			RaycastMode mode = RaycastMode::ALL, int maxHits = 1) override;
+
+		// trigger volumes (camera zones, checkpoints, ...), the player is a watcher
+		TriggerSystem& triggers() { return _triggers; }
+
+		// collision filtering between categories (default: all collide)
+		CollisionMatrix& collisionMatrix() { return _collisionMatrix; }
+
+		// collision narrowphase support
+		// - candidates: broadphase partners of obj + static objects in rect
+		//   tested by obj (see CollisionMatrix) and
+		//   having any of the given type bits (0 = any type)
+		//   (falls back to a rect query if obj is not in the broadphase)
+		// - stepCandidates: superset of the candidates of obj within any rect
+		//   inside reach, valid while queryEpoch does not change (same step):
+		//   broadphase partners are not filtered by rect as they may still move
+		//   (returns false if obj is not in the broadphase)
+		// - candidatesWithin: candidates within rect, filtered from stepCandidates
+		//   (same result of collisionCandidates, without queries)
+		// - firstContact: true only once per pair and per step (logic collisions)
+		void collisionCandidates(Object* obj, const RectF& rect, std::vector<Object*>& result, TypeMask typeMask = 0);
+		bool stepCandidates(Object* obj, const RectF& reach, std::vector<Object*>& result, TypeMask typeMask = 0);
+		void candidatesWithin(Object* obj, const RectF& rect, const std::vector<Object*>& superset, std::vector<Object*>& result, TypeMask typeMask = 0);
+		unsigned int queryEpoch() const { return _queryEpoch; }
+		bool firstContact(Object* a, Object* b) { return _broadphase.firstContact(a, b); }
 
 		// overrides Scene's render (+overlay scenes)
 		virtual void render() override;
 
+		// extends render snapshots (+overlay scenes, +interpolation)
+		virtual bool snapshotSupported() const override { return true; }
+		virtual void captureSnapshot(RenderSnapshot& snapshot) override;
+		virtual void publishSnapshot() override;
+		virtual void renderSnapshot() override;
+
 		// implements game scene update logic (+overlay, controls, +integration, +camera)
 		virtual void update(float timeToSimulate) override;
 
@@ -7,12 +7,13 @@
 // See LICENSE in root directory for full details.
 // ----------------------------------------------------------------
 
+#include <atomic>
 #include "Object.h"
 #include "Scene.h"
 
 using namespace agp;
 
-static int created = 0;
+static std::atomic<int> created(0);	// objects may be created on loading threads
 
 Object::Object(Scene* scene, const RectF& rect, int layer)
 {
@@ -23,9 +24,42 @@ Object::Object(Scene* scene, const RectF& rect, int layer)
 	_freezed = false;
 	_killed = false;
 	_itersFromKilled = 0;
+	_static = false;
+	_typeMask = typeBit();
+	_collisionCategory = 0;
+	_collisionMask = 0;
+	_gridOversized = false;
+	_queryMark = 0;
+	_broadphaseIndex = -1;
+	_layerIndex = -1;
+	_physicsIndex = -1;
+	_batchPhysics = false;
+	_awake = true;
+	_alwaysAwake = false;
+	_prevPos = _rect.pos;
 	_scene->newObject(this);
 }
 
+void Object::setRect(const RectF& rect)
+{
+	_rect = rect;
+	resetInterpolation();
+	_scene->objectMoved(this);
+}
+
+void Object::setPos(const PointF& newPos)
+{
+	_rect.pos = newPos;
+	resetInterpolation();
+	_scene->objectMoved(this);
+}
+
+void Object::setSize(const PointF& newSize)
+{
+	_rect.size = newSize;
+	_scene->objectMoved(this);
+}
+
 void Object::update(float dt)
 {
 	if (_killed)
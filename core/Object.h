@@ -9,6 +9,8 @@
 
 #pragma once
 #include <map>
+#include <cstdint>
+#include <type_traits>
 #include "Scheduler.h"
 #include "stringUtils.h"
 #include "geometryUtils.h"
@@ -17,6 +19,24 @@ namespace agp
 {
 	class Scene;
 	class Object;
+	class PhysicsStore;
+
+	// type tags: one bit per class of the Object hierarchy
+	// - each tagged class X declares 'typedef X TypeTagged' and a static typeBit(),
+	//   and adds its bit to the object's type mask in its constructor
+	// - core classes use the bits below, games define theirs from GAME_TYPES on
+	typedef uint64_t TypeMask;
+	enum CoreTypeBits { OBJECT_TYPE, RENDERABLE_TYPE, CLIPPER_TYPE, EDITABLE_TYPE, GAME_TYPES = 8 };
+
+	// collision categories: one bit per category, defined by games (see CollisionMatrix)
+	typedef uint32_t CollisionMask;
+
+	// whether class T has its own type tag (derived classes inherit TypeTagged)
+	template <class T, class = void>
+	struct isTypeTagged : std::false_type {};
+	template <class T>
+	struct isTypeTagged<T, typename std::enable_if<sizeof(typename T::TypeTagged) != 0>::type>
+		: std::is_same<typename T::TypeTagged, T> {};
 }
 
 // Object (or game object, or entity, or actor) abstract class.
@@ -27,6 +47,7 @@ namespace agp
 // - stores object layer in the scene (useful for sorting e.g. for Painter's algorithm)
 // - stores general state flags
 // - offers update and schedule methods, and simple geometric queries
+// - offers fast type tests/conversions based on type tags
 class agp::Object
 {
 	protected:
@@ -36,11 +57,36 @@ class agp::Object
 		int _layer;
 		int _id;
 		bool _freezed;	// if false, does not update
+		bool _static;	// if true, never moves (can be indexed once)
+		TypeMask _typeMask;	// type bits of the object class and its ancestors
+		CollisionMask _collisionCategory;	// category bit(s) of the object (0 = none)
+		CollisionMask _collisionMask;		// categories the object collides with
 		bool _killed;
 		int _itersFromKilled;
 		std::map<std::string, Scheduler> _schedulers;
 
+		// spatial indexing (managed by SpatialGrid)
+		RectI _gridCells;			// range of grid cells the object is binned into
+		bool _gridOversized;		// if true, stored in the grid's oversized list
+		unsigned int _queryMark;	// last query that visited this object
+		int _broadphaseIndex;		// index in the broadphase (-1 if none)
+		int _layerIndex;			// index in the scene layer (-1 if none)
+		int _physicsIndex;			// index in the physics store (-1 if none)
+		bool _batchPhysics;			// if true, integrated by the scene's physics store
+
+		// simulation activation (managed by GameScene)
+		bool _awake;				// if false, suspended or ticked at reduced rate
+		bool _alwaysAwake;			// if true, never put to sleep (e.g. player)
+
+		// render interpolation (managed by GameScene)
+		PointF _prevPos;			// pos at the start of the last simulation step
+
 		friend class Scene;
+		friend class SpatialGrid;
+		friend class SweepAndPrune;
+		friend class PhysicsStore;
+		friend class GameScene;
+		friend class View;
 
 	public:
 
@@ -49,22 +95,59 @@ class agp::Object
 
 		// getters/setters
 		const RectF& rect() const { return _rect; }
-		virtual void setRect(const RectF& rect) { _rect = rect; }
+		virtual void setRect(const RectF& rect);
 		PointF pos() const { return _rect.pos; }
-		virtual void setPos(const PointF& newPos) { _rect.pos = newPos; }
+		virtual void setPos(const PointF& newPos);
 		PointF size() const { return _rect.size; }
-		virtual void setSize(const PointF& newSize) { _rect.size = newSize; }
+		virtual void setSize(const PointF& newSize);
 		int layer() const { return _layer; }
 		bool freezed() const { return _freezed; }
 		virtual void setFreezed(bool on) { _freezed = on; }
 		void toggleFreezed() { _freezed = !_freezed; }
+		bool isStatic() const { return _static; }
+		bool awake() const { return _awake; }
+		bool alwaysAwake() const { return _alwaysAwake; }
+		void setAlwaysAwake(bool on) { _alwaysAwake = on; }
 		Scene* scene() const { return _scene; }
 
+		// render interpolation between the last two simulation steps (see GameScene)
+		// resetInterpolation: after teleports, to be drawn at once in the new pos
+		// (done by setPos/setRect: physics moves objects without them)
+		// NOTE: setRect/setPos/setSize also update the scene indices at once
+		PointF interpolatedPos(float alpha) const { return _prevPos + (_rect.pos - _prevPos) * alpha; }
+		void resetInterpolation() { _prevPos = _rect.pos; }
+
+		// collision filtering (checked before any narrowphase work)
+		// NOTE: static objects must be set before entering the scene (or the
+		// scene static index invalidated), since the index groups categories
+		CollisionMask collisionCategory() const { return _collisionCategory; }
+		CollisionMask collisionMask() const { return _collisionMask; }
+		void setCollisionFilter(CollisionMask category, CollisionMask mask) { _collisionCategory = category; _collisionMask = mask; }
+
 		// geometric queries
 		virtual bool contains(const Vec2Df& p) { return _rect.contains(p); }
 		virtual bool intersectsRectShallow(const RectF& r) { return _rect.intersects(r); }
 		virtual bool intersectsLine(const LineF& line, float& tNear) { return _rect.intersectsLine(line.start, line.end, tNear); }
 
+		// platform carry at the end of the step (see GameScene::addCarry)
+		// default: plain move by the platform displacement
+		virtual void carriedBy(Object* platform, const Vec2Df& displacement) { _rect.pos += displacement; }
+
+		// collision broadphase: bounds enclosing the object during the next step
+		// returns false if the object does not take part in the broadphase (default)
+		virtual bool broadphaseBounds(float dt, RectF& bounds) { return false; }
+
+		// batch physics: state moved to slot i of the physics store when the
+		// object enters it, and back when it leaves (see PhysicsStore)
+		bool batchPhysics() const { return _batchPhysics; }
+		bool inPhysicsStore() const { return _physicsIndex >= 0; }
+		virtual void enterPhysics(PhysicsStore& store, int i) {}
+		virtual void leavePhysics(const PhysicsStore& store, int i) {}
+
+		// collision prediction before the objects update (see GameScene)
+		// read-only precomputation, may run concurrently with other objects
+		virtual void predictContacts(float dt) {}
+
 		// core game logic (physics, ...)
 		virtual void update(float dt);
 
@@ -72,9 +155,16 @@ class agp::Object
 		virtual void schedule(const std::string& id, float delaySeconds, std::function<void()> action, int loop = 0, bool overwrite = true);
 		virtual void unschedule(const std::string& id);
 
-		// type conversion
+		// type tag
+		typedef Object TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << OBJECT_TYPE; }
+		TypeMask typeMask() const { return _typeMask; }
+
+		// type test/conversion: single AND for tagged classes, dynamic_cast otherwise
 		template <class T>
-		T to() { return dynamic_cast<T>(this); }
+		bool is() const { return isType<T>(isTypeTagged<T>()); }
+		template <class T>
+		T to() { return toType<typename std::remove_pointer<T>::type>(isTypeTagged<typename std::remove_pointer<T>::type>()); }
 
 		// kill
 		virtual void kill();
@@ -82,4 +172,15 @@ class agp::Object
 		// debugging
 		int id() const { return _id; }
 		virtual std::string name() { return strprintf("Object[%d]", _id); }
+
+	private:
+
+		template <class T>
+		bool isType(std::true_type) const { return (_typeMask & T::typeBit()) != 0; }
+		template <class T>
+		bool isType(std::false_type) const { return dynamic_cast<const T*>(this) != nullptr; }
+		template <class T>
+		T* toType(std::true_type) { return (_typeMask & T::typeBit()) ? static_cast<T*>(this) : nullptr; }
+		template <class T>
+		T* toType(std::false_type) { return dynamic_cast<T*>(this); }
 };
\ No newline at end of file
@@ -0,0 +1,151 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "PhysicsStore.h"
+#include "Object.h"
+#include "ThreadPool.h"
+
+using namespace agp;
+
+void PhysicsStore::resize(size_t n)
+{
+	velX.resize(n);
+	velY.resize(n);
+	prevVelX.resize(n);
+	prevVelY.resize(n);
+	nextVelX.resize(n);
+	nextVelY.resize(n);
+	gravity.resize(n);
+	moveForce.resize(n);
+	friction.resize(n);
+	skidding.resize(n);
+	velMaxX.resize(n);
+	velMaxY.resize(n);
+	velMinX.resize(n);
+	velMinY.resize(n);
+	dirX.resize(n);
+	active.resize(n);
+	pending.resize(n);
+}
+
+void PhysicsStore::moveSlot(int from, int to)
+{
+	velX[to] = velX[from];
+	velY[to] = velY[from];
+	prevVelX[to] = prevVelX[from];
+	prevVelY[to] = prevVelY[from];
+	nextVelX[to] = nextVelX[from];
+	nextVelY[to] = nextVelY[from];
+	gravity[to] = gravity[from];
+	moveForce[to] = moveForce[from];
+	friction[to] = friction[from];
+	skidding[to] = skidding[from];
+	velMaxX[to] = velMaxX[from];
+	velMaxY[to] = velMaxY[from];
+	velMinX[to] = velMinX[from];
+	velMinY[to] = velMinY[from];
+	dirX[to] = dirX[from];
+	active[to] = active[from];
+	pending[to] = pending[from];
+}
+
+void PhysicsStore::add(Object* obj)
+{
+	if (obj->_physicsIndex >= 0)
+		return;
+
+	int index = int(_bodies.size());
+	_bodies.push_back(obj);
+	resize(_bodies.size());
+	active[index] = 0;
+	pending[index] = 0;
+
+	// from now on the body state lives in its slot
+	obj->_physicsIndex = index;
+	obj->enterPhysics(*this, index);
+}
+
+void PhysicsStore::remove(Object* obj)
+{
+	int index = obj->_physicsIndex;
+	if (index < 0)
+		return;
+
+	// state back to the body
+	obj->leavePhysics(*this, index);
+	obj->_physicsIndex = -1;
+
+	// swap-and-pop: bodies order does not matter
+	int last = int(_bodies.size()) - 1;
+	if (index != last)
+	{
+		moveSlot(last, index);
+		_bodies[index] = _bodies[last];
+		_bodies[index]->_physicsIndex = index;
+	}
+	_bodies.pop_back();
+	resize(_bodies.size());
+}
+
+void PhysicsStore::clear()
+{
+	for (int i = 0; i < size(); i++)
+	{
+		_bodies[i]->leavePhysics(*this, i);
+		_bodies[i]->_physicsIndex = -1;
+	}
+	_bodies.clear();
+	resize(0);
+}
+
+void PhysicsStore::update(float dt, ThreadPool* pool)
+{
+	auto bodies = [this, dt](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+				active[i] = !_bodies[i]->_freezed && _bodies[i]->_awake;
+
+			integrate(dt, begin, end);
+		};
+
+	if (pool)
+		pool->parallelFor(size(), 256, bodies);
+	else
+		bodies(0, size());
+}
+
+void PhysicsStore::integrate(float dt, int begin, int end)
+{
+	// plain arrays help the compiler prove there is no aliasing
+	const float* vx = velX.data();
+	const float* vy = velY.data();
+	float* nvx = nextVelX.data();
+	float* nvy = nextVelY.data();
+	const float* g = gravity.data();
+	const float* mf = moveForce.data();
+	const float* fr = friction.data();
+	const float* sk = skidding.data();
+	const float* maxX = velMaxX.data();
+	const float* maxY = velMaxY.data();
+	const float* minX = velMinX.data();
+	const float* minY = velMinY.data();
+	const int* dir = dirX.data();
+	const unsigned char* act = active.data();
+	unsigned char* pend = pending.data();
+
+	// current velocity is left untouched: bodies commit the integrated one
+	// in their update (inactive bodies have nothing to commit)
+	for (int i = begin; i < end; i++)
+	{
+		nvx[i] = vx[i];
+		nvy[i] = vy[i];
+		integrateVelocity(nvx[i], nvy[i], dir[i], g[i], mf[i], fr[i], sk[i], maxX[i], maxY[i], minX[i], minY[i], dt);
+		pend[i] = act[i];
+	}
+}
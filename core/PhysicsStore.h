@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace agp
+{
+	class Object;
+	class PhysicsStore;
+	class ThreadPool;
+}
+
+// PhysicsStore class
+// - structure-of-arrays storage of the physics state of bodies
+//   (velocities, forces, velocity limits, horizontal direction)
+// - owns that state while bodies are in it: bodies move their state in
+//   when added and back out when removed, and in between their per-object
+//   API reads and writes their slot (no per-step copies nor virtual calls)
+// - integrates the velocities of all active bodies in one tight loop
+//   (same semantics of per-object integration, see integrateVelocity)
+// - integrated velocities are pending until each body commits them in its
+//   own update; bodies whose state was changed in between (scheduled
+//   actions, collisions of objects updated before) integrate on their own
+//   instead, hence results match per-object integration
+// - positions are not stored: bodies move with the integrated velocity
+//   during their own update (collision detection may change it)
+class agp::PhysicsStore
+{
+	public:
+
+		// per-body arrays (scene units/s)
+		std::vector<float> velX, velY;				// velocity
+		std::vector<float> prevVelX, prevVelY;		// velocity before integration
+		std::vector<float> nextVelX, nextVelY;		// integrated velocity (if pending)
+		std::vector<float> gravity;					// vertical acceleration
+		std::vector<float> moveForce;				// horizontal acceleration (movement)
+		std::vector<float> friction;				// horizontal deceleration (movement release)
+		std::vector<float> skidding;				// horizontal deceleration (movement change)
+		std::vector<float> velMaxX, velMaxY;		// max velocity
+		std::vector<float> velMinX, velMinY;		// min velocity (below = 0)
+		std::vector<int> dirX;						// -1 = left, 0 = none, 1 = right
+		std::vector<unsigned char> active;			// if 0 (freezed or asleep), not integrated
+		std::vector<unsigned char> pending;			// if 1, next velocity to be committed
+
+	protected:
+
+		std::vector<Object*> _bodies;
+
+		void resize(size_t n);
+		void moveSlot(int from, int to);
+
+	public:
+
+		PhysicsStore() {}
+
+		// add/remove bodies
+		void add(Object* obj);
+		void remove(Object* obj);
+		void clear();
+		int size() const { return int(_bodies.size()); }
+
+		// integrates all active bodies (results pending, see commit)
+		// (pool: in parallel chunks of bodies, each body only touches its own state)
+		void update(float dt, ThreadPool* pool = nullptr);
+
+		// velocity integration of the active bodies in [begin, end) (no virtual
+		// calls, no branches on data other than selects, auto-vectorizable)
+		void integrate(float dt, int begin, int end);
+		void integrate(float dt) { integrate(dt, 0, size()); }
+
+		// velocity of body i after integration: commits the pending one and
+		// returns true, or returns false if there is none (state changed
+		// after the batch pass or body not active: per-object integration)
+		bool commit(int i)
+		{
+			if (!pending[i])
+				return false;
+			prevVelX[i] = velX[i];
+			prevVelY[i] = velY[i];
+			velX[i] = nextVelX[i];
+			velY[i] = nextVelY[i];
+			pending[i] = 0;
+			return true;
+		}
+
+		// semi-implicit Euler velocity integration of a single body
+		// - gravity, then horizontal move/friction/skidding accelerations
+		// - after each acceleration, velocity is clipped to [-max, max] and
+		//   components below min are zeroed (x only when not moving)
+		static inline void integrateVelocity(float& vx, float& vy, int dir,
+			float gravity, float moveForce, float friction, float skidding,
+			float velMaxX, float velMaxY, float velMinX, float velMinY, float dt)
+		{
+			// gravity
+			vy += gravity * dt;
+			clip(vx, vy, dir, velMaxX, velMaxY, velMinX, velMinY);
+
+			// horizontal accelerations and decelerations
+			float versX = vx ? vx / std::abs(vx) : 0;
+			float ax =
+				dir == 0 ? -versX * friction * dt :
+				(dir > 0 ? vx >= 0 : vx <= 0) ? (dir > 0 ? moveForce * dt : -moveForce * dt) :
+				-versX * skidding * dt;
+			vx += ax;
+			clip(vx, vy, dir, velMaxX, velMaxY, velMinX, velMinY);
+		}
+
+		static inline void clip(float& vx, float& vy, int dir,
+			float velMaxX, float velMaxY, float velMinX, float velMinY)
+		{
+			vx = std::min(std::max(vx, -velMaxX), velMaxX);
+			vy = std::min(std::max(vy, -velMaxY), velMaxY);
+			vx = (dir == 0 && std::abs(vx) < velMinX) ? 0 : vx;
+			vy = std::abs(vy) < velMinY ? 0 : vy;
+		}
+};
@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include "RenderSnapshot.h"
+#include "Sprite.h"
+
+using namespace agp;
+
+RenderSnapshot::RenderSnapshot()
+{
+	visible = false;
+	alpha = 1;
+	dt = 0;
+}
+
+float RenderSnapshot::alphaAt(std::chrono::steady_clock::time_point now) const
+{
+	if (dt <= 0)
+		return 1;
+
+	std::chrono::duration<float> elapsed = now - time;
+	return std::min(alpha + elapsed.count() / dt, 1.0f);
+}
+
+void RenderSnapshot::addFill(const RectF& rect, const Color& color, const Vec2Df& step)
+{
+	items.emplace_back();
+	Item& item = items.back();
+	item.kind = Kind::FILL;
+	item.rect = rect;
+	item.color = color;
+	item.step = step;
+}
+
+void RenderSnapshot::addSprite(Sprite* sprite, const RectF& rect, float angle, SDL_RendererFlip flip, bool fit, const Vec2Df& step)
+{
+	items.emplace_back();
+	Item& item = items.back();
+	item.kind = Kind::SPRITE;
+	item.sprite = sprite;
+	item.frame = sprite->rect();
+	item.rect = rect;
+	item.angle = angle;
+	item.flip = flip;
+	item.fit = fit;
+	item.step = step;
+}
+
+void RenderSnapshot::addRect(const RectF& rect, const Color& color, const Vec2Df& step, float thickness)
+{
+	items.emplace_back();
+	Item& item = items.back();
+	item.kind = Kind::RECT;
+	item.rect = rect;
+	item.color = color;
+	item.thickness = thickness;
+	item.step = step;
+}
+
+void RenderSnapshot::addPolygon(const std::array<PointF, 4>& vertices, const Color& color, const Vec2Df& step)
+{
+	items.emplace_back();
+	Item& item = items.back();
+	item.kind = Kind::POLYGON;
+	item.vertices = vertices;
+	item.color = color;
+	item.step = step;
+}
+
+void RenderSnapshot::addLine(const LineF& line, const Color& color, const Vec2Df& step)
+{
+	items.emplace_back();
+	Item& item = items.back();
+	item.kind = Kind::LINE;
+	item.vertices[0] = line.start;
+	item.vertices[1] = line.end;
+	item.color = color;
+	item.step = step;
+}
+
+RenderSnapshotBuffer::RenderSnapshotBuffer()
+{
+	_back = 0;
+	_ready = 1;
+	_front = 2;
+	_fresh = false;
+	_published = false;
+}
+
+void RenderSnapshotBuffer::publish()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::swap(_back, _ready);
+	_fresh = true;
+	_published = true;
+}
+
+const RenderSnapshot* RenderSnapshotBuffer::latest()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_fresh)
+	{
+		std::swap(_front, _ready);
+		_fresh = false;
+	}
+
+	return _published ? &_snapshots[_front] : nullptr;
+}
@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <array>
+#include <mutex>
+#include <chrono>
+#include "SDL.h"
+#include "geometryUtils.h"
+#include "graphicsUtils.h"
+
+namespace agp
+{
+	class RenderSnapshot;
+	class RenderSnapshotBuffer;
+	class Sprite;
+}
+
+// RenderSnapshot class
+// - copy of what a view draws, captured by the simulation at the end of
+//   an update and drawn later (possibly on another thread)
+// - plain draw items in painter's order, no object references: sprite
+//   frames, filled rects, outlines and lines, each with the displacement
+//   of its object over the last step (render interpolation)
+// - view geometry is captured too: the snapshot is drawn without reading
+//   the scene nor the view
+// NOTE: sprites are only used to blit the captured frame, hence they
+//       must outlive the snapshot (not their current frame)
+class agp::RenderSnapshot
+{
+	public:
+
+		enum class Kind { FILL, SPRITE, RECT, POLYGON, LINE };
+
+		struct Item
+		{
+			Kind kind;
+			Vec2Df step;			// object displacement over the last step
+			RectF rect;				// FILL, SPRITE, RECT
+			Color color;			// FILL, RECT, POLYGON, LINE
+			float thickness;		// RECT: in screen points (0 = thin)
+			std::array<PointF, 4> vertices;	// POLYGON (closed), LINE (first two)
+			Sprite* sprite;			// SPRITE
+			RectI frame;			// SPRITE: spritesheet rect at capture time
+			float angle;			// SPRITE: degrees, clockwise
+			SDL_RendererFlip flip;	// SPRITE
+			bool fit;				// SPRITE
+		};
+
+		// view and scene state at capture time
+		bool visible;				// if false, nothing is drawn
+		RectF viewRect;				// view rect in scene coords
+		Vec2Df viewStep;			// view displacement over the last step (e.g. follow cam)
+		RectF viewport;				// in absolute window coords
+		RectF clipRect;				// in absolute window coords (invalid = viewport)
+		PointF magf;				// view rect to viewport ratio
+		Color backgroundColor;
+		Point pixelUnitSize;
+
+		// render interpolation
+		float alpha;				// interpolation alpha at capture time
+		float dt;					// simulation step (0 = no interpolation)
+		std::chrono::steady_clock::time_point time;	// capture time
+
+		std::vector<Item> items;	// painter's order (reused)
+
+		RenderSnapshot();
+
+		// interpolation alpha at the given time (advances at the
+		// simulation rate from capture time, never beyond the last step)
+		float alphaAt(std::chrono::steady_clock::time_point now) const;
+
+		// add draw items (see RenderableObject::snapshot)
+		void addFill(const RectF& rect, const Color& color, const Vec2Df& step);
+		void addSprite(Sprite* sprite, const RectF& rect, float angle, SDL_RendererFlip flip, bool fit, const Vec2Df& step);
+		void addRect(const RectF& rect, const Color& color, const Vec2Df& step, float thickness = 0);
+		void addPolygon(const std::array<PointF, 4>& vertices, const Color& color, const Vec2Df& step);
+		void addLine(const LineF& line, const Color& color, const Vec2Df& step);
+};
+
+// RenderSnapshotBuffer class
+// - hands snapshots over from the simulation to the render thread
+// - the simulation captures into the back snapshot and publishes it,
+//   the render takes the latest published one: a third snapshot, swapped
+//   under a short lock, lets neither side wait for the other
+class agp::RenderSnapshotBuffer
+{
+	protected:
+
+		RenderSnapshot _snapshots[3];
+		int _back;					// being captured (simulation)
+		int _ready;					// latest published
+		int _front;					// being drawn (render)
+		bool _fresh;				// _ready not taken yet
+		bool _published;			// any snapshot published so far
+		std::mutex _mutex;
+
+	public:
+
+		RenderSnapshotBuffer();
+
+		// simulation side
+		RenderSnapshot& back() { return _snapshots[_back]; }
+		void publish();
+
+		// render side: latest published snapshot (nullptr if none yet)
+		const RenderSnapshot* latest();
+};
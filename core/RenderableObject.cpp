@@ -9,6 +9,7 @@
 
 #include "RenderableObject.h"
 #include "Scene.h"
+#include "RenderSnapshot.h"
 #include "sdlUtils.h"
 
 using namespace agp;
@@ -16,6 +17,7 @@ using namespace agp;
 RenderableObject::RenderableObject(Scene* scene, const RectF& rect, const Color& color, int layer)
 	: Object(scene, rect, layer)
 {
+	_typeMask |= typeBit();
 	_color = color;
 	_fit = true;
 	_flip = SDL_FLIP_NONE;
@@ -33,6 +35,7 @@ RenderableObject::RenderableObject(Scene* scene, const RectF& rect, const Color&
 RenderableObject::RenderableObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer, bool fit)
 	: Object(scene, rect, layer)
 {
+	_typeMask |= typeBit();
 	_color = { 0,0,0,0 };
 	_fit = fit;
 	_flip = SDL_FLIP_NONE;
@@ -92,6 +95,34 @@ void RenderableObject::draw(SDL_Renderer* renderer, Transform camera)
 	}
 }
 
+void RenderableObject::snapshot(RenderSnapshot& snapshot)
+{
+	if (!_visible)
+		return;
+
+	Vec2Df step = _rect.pos - _prevPos;
+
+	if (_backgroundColor.a)
+		snapshot.addFill(_rect, _backgroundColor, step);
+
+	if (_sprite)
+		snapshot.addSprite(_sprite, _rect, _angle, _flip, _fit, step);
+	else
+		snapshot.addFill(_rect, _color, step);
+
+	if (_scene->rectsVisible())
+		snapshot.addRect(_rect, _rectColor, step);
+
+	if (_borderColor.a)
+		snapshot.addRect(_rect, _borderColor, step, _borderThickness);
+
+	if (_focused)
+	{
+		snapshot.addFill(_rect, _focusColor, step);
+		_focused = false;
+	}
+}
+
 void RenderableObject::update(float dt)
 {
 	Object::update(dt);
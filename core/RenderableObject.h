@@ -16,6 +16,7 @@ namespace agp
 {
 	class Scene;
 	class RenderableObject;
+	class RenderSnapshot;
 }
 
 // RenderableObject class.
@@ -41,6 +42,10 @@ class agp::RenderableObject : public Object
 
 	public:
 
+		// type tag
+		typedef RenderableObject TypeTagged;
+		static constexpr TypeMask typeBit() { return TypeMask(1) << RENDERABLE_TYPE; }
+
 		RenderableObject(Scene* scene, const RectF& rect, const Color& color, int layer = 0);
 		RenderableObject(Scene* scene, const RectF& rect, Sprite* sprite, int layer = 0, bool fit = true);
 		virtual ~RenderableObject() {}
@@ -64,6 +69,9 @@ class agp::RenderableObject : public Object
 		// core game rendering
 		virtual void draw(SDL_Renderer* renderer, Transform camera);
 
+		// same as draw, captured as draw items (see RenderSnapshot)
+		virtual void snapshot(RenderSnapshot& snapshot);
+
 		virtual std::string name() override {
 			return strprintf("RenderableObject[%d]", _id);
 		}
@@ -25,23 +25,26 @@ Scene::Scene(const RectF& rect, const Point& pixelUnitSize)
 	_blocking = false;
 	_view = nullptr;
 	_rectsVisible = false;
+	_visitDepth = 0;
+	_snapshotRendering = false;
 }
 
 Scene::~Scene()
 {
 	for (auto& layer : _sortedObjects)
-		for(auto& obj : layer.second)
+		for(auto& obj : layer.objects)
 			delete obj;
 }
 
 void Scene::newObject(Object* obj)
 {
-	_newObjects.insert(obj);
+	_newObjects.push_back(obj);
 }
 
 void Scene::killObject(Object* obj)
 {
-	_deadObjects.insert(obj);
+	if (!obj->_killed)
+		_deadObjects.push_back(obj);
 	obj->_killed = true;
 }
 
@@ -50,117 +53,272 @@ void Scene::changeLayerObject(Object* obj, int newLayer)
 	_changeLayerObjects.push_back(std::pair<int, Object*>(newLayer, obj));
 }
 
+Scene::Layer& Scene::layer(int z)
+{
+	auto it = firstLayer(z);
+	if (it == _sortedObjects.end() || it->z != z)
+		it = _sortedObjects.insert(it, Layer{ z, ObjectsVector() });
+	return *it;
+}
+
+Scene::LayersVector::iterator Scene::firstLayer(int minZ)
+{
+	return std::lower_bound(_sortedObjects.begin(), _sortedObjects.end(), minZ,
+		[](const Layer& layer, int z) { return layer.z < z; });
+}
+
+void Scene::removeMarkedObjects()
+{
+	// one stable compaction pass per layer that lost objects (marked with index -1),
+	// so that painter's order and creation order are preserved
+	for (int z : _dirtyLayers)
+	{
+		ObjectsVector& objects = layer(z).objects;
+		int w = 0;
+		for (int r = 0; r < int(objects.size()); r++)
+			if (objects[r]->_layerIndex >= 0)
+			{
+				objects[w] = objects[r];
+				objects[w]->_layerIndex = w;
+				w++;
+			}
+		objects.resize(w);
+	}
+	_dirtyLayers.clear();
+}
+
 void Scene::refreshObjects()
 {
-	for(auto& obj : _newObjects)
-		_sortedObjects[obj->layer()].emplace_back(obj);
+	for (auto& obj : _newObjects)
+	{
+		ObjectsVector& objects = layer(obj->layer()).objects;
+		obj->_layerIndex = int(objects.size());
+		objects.push_back(obj);
+		objectAdded(obj);
+	}
 	_newObjects.clear();
 
-	for (auto& p : _changeLayerObjects)
+	if (_changeLayerObjects.size())
 	{
-		auto& layer = _sortedObjects[p.second->layer()];
-		auto removeIt = std::remove(layer.begin(), layer.end(), p.second);
-		if (removeIt == layer.end())
-			std::cerr << "Cannot remove " << p.second->name() << " from layer " << p.second->layer() << " when changing layer: object not found\n";
-		layer.erase(removeIt, layer.end());
-
-		if (std::find(_sortedObjects[p.first].begin(), _sortedObjects[p.first].end(), p.second) == _sortedObjects[p.first].end())
+		// detach from old layers (the last request of each object wins)
+		_removedObjects.clear();
+		for (auto& p : _changeLayerObjects)
 		{
-			_sortedObjects[p.first].emplace_back(p.second);
-			p.second->_layer = p.first;
+			Object* obj = p.second;
+			if (obj->_layerIndex < 0 && std::find(_removedObjects.begin(), _removedObjects.end(), obj) != _removedObjects.end())
+			{
+				obj->_layer = p.first;
+				continue;
+			}
+
+			ObjectsVector& objects = layer(obj->layer()).objects;
+			if (obj->_layerIndex < 0 || obj->_layerIndex >= int(objects.size()) || objects[obj->_layerIndex] != obj)
+			{
+				std::cerr << "Cannot remove " << obj->name() << " from layer " << obj->layer() << " when changing layer: object not found\n";
+				continue;
+			}
+			obj->_layerIndex = -1;
+			if (std::find(_dirtyLayers.begin(), _dirtyLayers.end(), obj->layer()) == _dirtyLayers.end())
+				_dirtyLayers.push_back(obj->layer());
+			obj->_layer = p.first;
+			_removedObjects.push_back(obj);
 		}
-		else
-			std::cerr << "Cannot re-insert " << p.second->name() << " in layer " << p.first << " when changing layer: object already present\n";
+		removeMarkedObjects();
 
+		// attach to new layers in request order
+		for (auto obj : _removedObjects)
+		{
+			ObjectsVector& objects = layer(obj->layer()).objects;
+			obj->_layerIndex = int(objects.size());
+			objects.push_back(obj);
+		}
+		_changeLayerObjects.clear();
 	}
-	_changeLayerObjects.clear();
 
-	for (auto it = _deadObjects.begin(); it != _deadObjects.end(); )
+	// dead objects are removed 2 iterations after being killed
+	_removedObjects.clear();
+	int pending = 0;
+	for (auto obj : _deadObjects)
 	{
-		Object* obj = *it;
-
 		if (obj->_itersFromKilled < 2)
 		{
-			++it; // Move to the next element
+			_deadObjects[pending++] = obj;
 			continue;
 		}
 
-		auto& layer = _sortedObjects[obj->layer()];
-		auto removeIt = std::remove(layer.begin(), layer.end(), obj);
-		if (removeIt == layer.end())
+		ObjectsVector& objects = layer(obj->layer()).objects;
+		if (obj->_layerIndex < 0 || obj->_layerIndex >= int(objects.size()) || objects[obj->_layerIndex] != obj)
 			std::cerr << "Cannot remove " << obj->name() << " from layer " << obj->layer() << ": object not found\n";
-		layer.erase(removeIt, layer.end());
+		else
+		{
+			obj->_layerIndex = -1;
+			if (std::find(_dirtyLayers.begin(), _dirtyLayers.end(), obj->layer()) == _dirtyLayers.end())
+				_dirtyLayers.push_back(obj->layer());
+		}
+		_removedObjects.push_back(obj);
+	}
+	_deadObjects.resize(pending);
+	removeMarkedObjects();
 
-		// Erase the element from the set and advance the iterator safely
-		it = _deadObjects.erase(it); // 'erase' returns an iterator to the next element
+	for (auto obj : _removedObjects)
+	{
+		objectRemoved(obj);
 		delete obj;
 	}
+	_removedObjects.clear();
 }
 
-std::list<Object*> Scene::objects()
+void Scene::objects(ObjectsVector& result, const QueryFilter& filter)
 {
-	std::list<Object*> allObjects;
-	for (auto& layer : _sortedObjects)
-		for (auto& obj : layer.second)
-			allObjects.push_back(obj);
-
-	return allObjects;
+	result.clear();
+	for (auto layer = firstLayer(filter.minLayer);
+		layer != _sortedObjects.end() && layer->z <= filter.maxLayer; layer++)
+		for (auto& obj : layer->objects)
+			if (filter.accepts(obj))
+				result.push_back(obj);
 }
 
-std::list<Object*> Scene::objects(const RectF& cullingRect)
+void Scene::objects(const RectF& cullingRect, ObjectsVector& result, const QueryFilter& filter)
 {
-	std::list<Object*> objectsInRect;
-	for (auto& layer : _sortedObjects)
-		for (auto& obj : layer.second)
-			if (obj->intersectsRectShallow(cullingRect))
-				objectsInRect.push_back(obj);
-
-	return objectsInRect;
+	result.clear();
+	for (auto layer = firstLayer(filter.minLayer);
+		layer != _sortedObjects.end() && layer->z <= filter.maxLayer; layer++)
+		for (auto& obj : layer->objects)
+			if (filter.accepts(obj) && obj->intersectsRectShallow(cullingRect))
+				result.push_back(obj);
 }
 
-std::list<Object*> Scene::objects(const PointF& containPoint)
+void Scene::objects(const PointF& containPoint, ObjectsVector& result, const QueryFilter& filter)
 {
-	std::list<Object*> objectsSelected;
-	for (auto& layer : _sortedObjects)
-		for (auto& obj : layer.second)
-			if (obj->contains(containPoint))
-				objectsSelected.push_back(obj);
-
-	return objectsSelected;
+	result.clear();
+	for (auto layer = firstLayer(filter.minLayer);
+		layer != _sortedObjects.end() && layer->z <= filter.maxLayer; layer++)
+		for (auto& obj : layer->objects)
+			if (filter.accepts(obj) && obj->contains(containPoint))
+				result.push_back(obj);
 }
 
-agp::Scene::ObjectsList Scene::raycast(const LineF& line)
+void Scene::raycast(const LineF& line, ObjectsVector& result, const QueryFilter& filter, RaycastMode mode, int maxHits)
 {
-	std::vector<std::pair<Object*, float>> hits;
+	objects(line.boundingRect(_rect.yUp), result, filter);
 
-	auto objectsInRect = objects(line.boundingRect(_rect.yUp));
-	for (Object* obj : objectsInRect)
+	_raycastHits.clear();
+	for (Object* obj : result)
 	{
 		float tNear;
 		if (obj->intersectsLine(line, tNear))
-			hits.push_back({ obj, tNear });
+			_raycastHits.push_back({ obj, tNear });
 	}
 
-	// sort the hits based on the distance along the line (tNear):
-	std::sort(hits.begin(), hits.end(),
+	// sort the hits based on the distance along the line (tNear), ties by creation order
+	std::sort(_raycastHits.begin(), _raycastHits.end(),
 		[](const std::pair<Object*, float>& a, const std::pair<Object*, float>& b) {
-			return a.second < b.second;
+			return a.second != b.second ? a.second < b.second : a.first->id() < b.first->id();
 		});
 
+	// keep only the requested hits
+	if (mode == RaycastMode::ANY)
+		maxHits = 1;
+	if (mode != RaycastMode::ALL && int(_raycastHits.size()) > maxHits)
+		_raycastHits.resize(std::max(maxHits, 0));
+
 	// extract the Object pointers from the sorted hits:
-	std::list<Object*> result;
-	for (const auto& hit : hits)
+	result.clear();
+	for (const auto& hit : _raycastHits)
 		result.push_back(hit.first);
+}
 
-	return result;
+Object* Scene::raycastClosest(const LineF& line, const QueryFilter& filter)
+{
+	raycast(line, _raycastResult, filter, RaycastMode::CLOSEST, 1);
+	return _raycastResult.empty() ? nullptr : _raycastResult.front();
+}
+
+void Scene::visit(const RectF& cullingRect, const ObjectVisitor& visitor, const QueryFilter& filter)
+{
+	// each nesting level has its own buffer, so visitors can query the scene again
+	if (_visitDepth == int(_visitBuffers.size()))
+		_visitBuffers.emplace_back();
+	ObjectsVector& buffer = _visitBuffers[_visitDepth++];
+
+	objects(cullingRect, buffer, filter);
+	for (auto obj : buffer)
+		if (!visitor(obj))
+			break;
+
+	_visitDepth--;
+}
+
+void Scene::visit(const PointF& containPoint, const ObjectVisitor& visitor, const QueryFilter& filter)
+{
+	if (_visitDepth == int(_visitBuffers.size()))
+		_visitBuffers.emplace_back();
+	ObjectsVector& buffer = _visitBuffers[_visitDepth++];
+
+	objects(containPoint, buffer, filter);
+	for (auto obj : buffer)
+		if (!visitor(obj))
+			break;
+
+	_visitDepth--;
+}
+
+Scene::ObjectsList Scene::objects()
+{
+	ObjectsVector result;
+	objects(result);
+	return ObjectsList(result.begin(), result.end());
+}
+
+Scene::ObjectsList Scene::objects(const RectF& cullingRect)
+{
+	ObjectsVector result;
+	objects(cullingRect, result);
+	return ObjectsList(result.begin(), result.end());
+}
+
+Scene::ObjectsList Scene::objects(const PointF& containPoint)
+{
+	ObjectsVector result;
+	objects(containPoint, result);
+	return ObjectsList(result.begin(), result.end());
+}
+
+Scene::ObjectsList Scene::raycast(const LineF& line)
+{
+	ObjectsVector result;
+	raycast(line, result);
+	return ObjectsList(result.begin(), result.end());
 }
 
 void Scene::render()
 {
-	if (_visible && _view)
+	if (_snapshotRendering)
+		renderSnapshot();
+	else if (_visible && _view)
 		_view->render();
 }
 
+void Scene::captureSnapshot(RenderSnapshot& snapshot)
+{
+	snapshot.visible = _visible && _view;
+	if (snapshot.visible)
+		_view->capture(snapshot);
+}
+
+void Scene::publishSnapshot()
+{
+	captureSnapshot(_snapshots.back());
+	_snapshots.publish();
+}
+
+void Scene::renderSnapshot()
+{
+	const RenderSnapshot* snapshot = _snapshots.latest();
+	if (snapshot && snapshot->visible)
+		_view->render(*snapshot);
+}
+
 void Scene::update(float timeToSimulate)
 {
 	refreshObjects();
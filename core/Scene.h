@@ -11,10 +11,14 @@
 #include <map>
 #include <vector>
 #include <list>
-#include <set>
+#include <deque>
+#include <limits>
+#include <functional>
 #include "geometryUtils.h"
 #include "graphicsUtils.h"
 #include "Scheduler.h"
+#include "Object.h"
+#include "RenderSnapshot.h"
 
 namespace agp
 {
@@ -29,21 +33,80 @@ namespace agp
 // - contains objects sorted by ascending z-level (painter algorithm)
 // - provides efficient access to objects
 // - provides globale action scheduling
+// - can render from snapshots captured by the simulation (see Game)
 class agp::Scene
 {
+	friend class Object;
+
 	public:
 
-		typedef std::map< int, std::vector< Object*> > ObjectsMap;
 		typedef std::list< Object*> ObjectsList;
-		typedef std::set< Object*> ObjectsSet;
-		typedef std::list< std::pair<int, Object*>> ObjectsLayersList;
+		typedef std::vector< Object*> ObjectsVector;
+		typedef std::vector< std::pair<int, Object*>> ObjectsLayersList;
+		typedef std::function<bool(Object*)> ObjectVisitor;	// returns false to stop
+
+		// raycast modes
+		// - ALL: all hits, sorted along the ray
+		// - CLOSEST: the closest maxHits hits, sorted along the ray
+		// - ANY: a single hit, not necessarily the closest (e.g. line of sight)
+		enum class RaycastMode { ALL, CLOSEST, ANY };
+
+		// objects with the same z-level, in insertion order
+		struct Layer
+		{
+			int z;
+			ObjectsVector objects;
+		};
+		typedef std::vector< Layer> LayersVector;	// sorted by ascending z
+
+		// optional filter for geometric queries (default: accepts all)
+		// - layer range [minLayer, maxLayer]
+		// - type mask: accepts objects having any of its type bits (0 = any type)
+		// - accept predicate (nullptr = any)
+		struct QueryFilter
+		{
+			int minLayer;
+			int maxLayer;
+			bool (*accept)(Object*);
+			TypeMask typeMask;
+
+			QueryFilter(
+				int minL = std::numeric_limits<int>::min(),
+				int maxL = std::numeric_limits<int>::max(),
+				bool (*acceptFn)(Object*) = nullptr,
+				TypeMask mask = 0)
+				: minLayer(minL), maxLayer(maxL), accept(acceptFn), typeMask(mask) {}
+
+			bool accepts(Object* obj) const
+			{
+				return obj->layer() >= minLayer && obj->layer() <= maxLayer &&
+					(!typeMask || (obj->typeMask() & typeMask)) && (!accept || accept(obj));
+			}
+
+			static QueryFilter ofMask(TypeMask mask,
+				int minL = std::numeric_limits<int>::min(),
+				int maxL = std::numeric_limits<int>::max())
+			{
+				return QueryFilter(minL, maxL, nullptr, mask);
+			}
+
+			template <class T>
+			static QueryFilter ofType(
+				int minL = std::numeric_limits<int>::min(),
+				int maxL = std::numeric_limits<int>::max())
+			{
+				return QueryFilter(minL, maxL, [](Object* obj) { return obj->is<T>(); });
+			}
+		};
 
 	protected:
 		
-		ObjectsMap _sortedObjects;	// objects sorted by ascending z-level
-		ObjectsSet _newObjects;		// new objects that need to be added
-		ObjectsSet _deadObjects;	// dead objects that need to be deallocated
+		LayersVector _sortedObjects;	// objects sorted by ascending z-level
+		ObjectsVector _newObjects;		// new objects that need to be added (creation order)
+		ObjectsVector _deadObjects;		// dead objects that need to be deallocated (kill order)
 		ObjectsLayersList _changeLayerObjects;	// objects that need to change layer
+		ObjectsVector _removedObjects;	// reused by refreshObjects
+		std::vector<int> _dirtyLayers;	// reused by refreshObjects
 		RectF _rect;				// the scene (world) rectangle
 		Point _pixelUnitSize;		// unit size in pixels
 		Color _backgroundColor;		// background color
@@ -55,6 +118,27 @@ class agp::Scene
 		bool _rectsVisible;			// whether objects rects are visible
 		std::map<std::string, Scheduler> _schedulers;
 
+		// render snapshots (simulation on its own thread, see Game)
+		RenderSnapshotBuffer _snapshots;
+		bool _snapshotRendering;	// if true, render draws the latest snapshot
+
+		// query buffers (reused)
+		std::vector<std::pair<Object*, float>> _raycastHits;
+		ObjectsVector _raycastResult;
+		std::deque<ObjectsVector> _visitBuffers;	// one per nested visit (stable refs)
+		int _visitDepth;
+
+		// layers helper functions
+		Layer& layer(int z);
+		LayersVector::iterator firstLayer(int minZ);
+		void removeMarkedObjects();
+
+		// indexing hooks (called by refreshObjects when objects enter/leave the scene,
+		// and by the Object setters when objects are moved or resized outside physics)
+		virtual void objectAdded(Object* obj) {}
+		virtual void objectRemoved(Object* obj) {}
+		virtual void objectMoved(Object* obj) {}
+
 	public:
 
 		Scene(const RectF& rect, const Point& pixelUnitSize);
@@ -82,15 +166,57 @@ class agp::Scene
 		void changeLayerObject(Object* obj, int newLayer);
 		void refreshObjects();
 
-		// geometric queries
-		virtual ObjectsList objects();
-		virtual ObjectsList objects(const RectF& cullingRect);
-		virtual ObjectsList objects(const PointF& containPoint);
-		virtual ObjectsList raycast(const LineF& line);
+		// geometric queries (allocation-free)
+		// - results are written in painter's order (raycast: along the ray)
+		//   into a caller-owned vector, which is cleared first
+		virtual void objects(ObjectsVector& result, const QueryFilter& filter = QueryFilter());
+		virtual void objects(const RectF& cullingRect, ObjectsVector& result, const QueryFilter& filter = QueryFilter());
+		virtual void objects(const PointF& containPoint, ObjectsVector& result, const QueryFilter& filter = QueryFilter());
+		virtual void raycast(const LineF& line, ObjectsVector& result, const QueryFilter& filter = QueryFilter(),
+			RaycastMode mode = RaycastMode::ALL, int maxHits = 1);
+
+		// closest object crossed by the line (nullptr if none)
+		Object* raycastClosest(const LineF& line, const QueryFilter& filter = QueryFilter());
+
+		// geometric queries with visitor (allocation-free, may be nested)
+		void visit(const RectF& cullingRect, const ObjectVisitor& visitor, const QueryFilter& filter = QueryFilter());
+		void visit(const PointF& containPoint, const ObjectVisitor& visitor, const QueryFilter& filter = QueryFilter());
+
+		// typed geometric query (allocation-free)
+		template <class T>
+		void objectsOfType(const RectF& cullingRect, std::vector<T*>& result,
+			int minLayer = std::numeric_limits<int>::min(),
+			int maxLayer = std::numeric_limits<int>::max())
+		{
+			result.clear();
+			visit(cullingRect, [&result](Object* obj) { result.push_back(obj->to<T*>()); return true; },
+				QueryFilter::ofType<T>(minLayer, maxLayer));
+		}
+
+		// geometric queries (convenience: a new list is allocated at each call)
+		ObjectsList objects();
+		ObjectsList objects(const RectF& cullingRect);
+		ObjectsList objects(const PointF& containPoint);
+		ObjectsList raycast(const LineF& line);
 
 		// render
 		virtual void render();
 
+		// render from snapshots (only if supported: the scene state
+		// must be fully captured by its view, see RenderSnapshot)
+		// - capture/publish: simulation thread, after update
+		// - renderSnapshot: render thread, latest published snapshot
+		virtual bool snapshotSupported() const { return false; }
+		bool snapshotRendering() const { return _snapshotRendering; }
+		void setSnapshotRendering(bool on) { _snapshotRendering = on && snapshotSupported(); }
+		virtual void captureSnapshot(RenderSnapshot& snapshot);
+		virtual void publishSnapshot();
+		virtual void renderSnapshot();
+
+		// render interpolation factor between the previous and the current
+		// simulation state of the objects (1 = current state)
+		virtual float interpolationAlpha() const { return 1; }
+
 		// update
 		virtual void update(float timeToSimulate);
 
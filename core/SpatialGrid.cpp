@@ -0,0 +1,238 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include "SpatialGrid.h"
+#include "Object.h"
+
+using namespace agp;
+
+SpatialGrid::SpatialGrid(const RectF& rect, float cellSize, int maxCellsPerObject)
+{
+	_maxCellsPerObject = maxCellsPerObject;
+	_queryMark = 0;
+	_cols = _rows = 0;
+	_cellSize = cellSize;
+	reset(rect, cellSize);
+}
+
+void SpatialGrid::reset(const RectF& rect, float cellSize)
+{
+	clear();
+
+	_rect = rect;
+	_cellSize = cellSize;
+	_cols = std::max(1, int(std::ceil(_rect.size.x / _cellSize)));
+	_rows = std::max(1, int(std::ceil(_rect.size.y / _cellSize)));
+	_cells.clear();
+	_cells.resize(_cols * _rows);
+}
+
+void SpatialGrid::clear()
+{
+	for (auto& cell : _cells)
+	{
+		for (auto obj : cell)
+			obj->_gridCells = RectI();
+		cell.clear();
+	}
+	for (auto obj : _oversized)
+	{
+		obj->_gridCells = RectI();
+		obj->_gridOversized = false;
+	}
+	_oversized.clear();
+}
+
+RectI SpatialGrid::cellRange(const RectF& r) const
+{
+	// rect min/max corners do not depend on yUp (pos is always the min corner)
+	// clamping is done in the float domain to be robust to huge/infinite rects
+	float maxX = float(_cols - 1);
+	float maxY = float(_rows - 1);
+	int x0 = int(std::min(std::max(std::floor((r.pos.x - _rect.pos.x) / _cellSize), 0.0f), maxX));
+	int y0 = int(std::min(std::max(std::floor((r.pos.y - _rect.pos.y) / _cellSize), 0.0f), maxY));
+	int x1 = int(std::min(std::max(std::floor((r.pos.x + r.size.x - _rect.pos.x) / _cellSize), 0.0f), maxX));
+	int y1 = int(std::min(std::max(std::floor((r.pos.y + r.size.y - _rect.pos.y) / _cellSize), 0.0f), maxY));
+
+	return RectI(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+void SpatialGrid::insertCells(Object* obj, const RectI& cells)
+{
+	for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+		for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+			_cells[y * _cols + x].push_back(obj);
+}
+
+void SpatialGrid::removeCells(Object* obj, const RectI& cells)
+{
+	for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+		for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+		{
+			// cells are small and unordered: swap-and-pop
+			auto& cell = _cells[y * _cols + x];
+			auto it = std::find(cell.begin(), cell.end(), obj);
+			if (it != cell.end())
+			{
+				*it = cell.back();
+				cell.pop_back();
+			}
+		}
+}
+
+void SpatialGrid::add(Object* obj)
+{
+	if (obj->_gridCells.isValid() || obj->_gridOversized)
+		return;
+
+	RectI cells = cellRange(obj->rect());
+	if (cells.size.x * cells.size.y > _maxCellsPerObject)
+	{
+		obj->_gridOversized = true;
+		_oversized.push_back(obj);
+	}
+	else
+	{
+		insertCells(obj, cells);
+		obj->_gridCells = cells;
+	}
+}
+
+void SpatialGrid::remove(Object* obj)
+{
+	if (obj->_gridOversized)
+	{
+		auto it = std::find(_oversized.begin(), _oversized.end(), obj);
+		if (it != _oversized.end())
+			_oversized.erase(it);
+		obj->_gridOversized = false;
+	}
+	else if (obj->_gridCells.isValid())
+	{
+		removeCells(obj, obj->_gridCells);
+		obj->_gridCells = RectI();
+	}
+}
+
+void SpatialGrid::update(Object* obj)
+{
+	// oversized objects do not need to be re-binned
+	if (obj->_gridOversized || !obj->_gridCells.isValid())
+		return;
+
+	RectI cells = cellRange(obj->rect());
+	if (cells.pos == obj->_gridCells.pos && cells.size == obj->_gridCells.size)
+		return;
+
+	removeCells(obj, obj->_gridCells);
+	obj->_gridCells = RectI();
+	add(obj);
+}
+
+unsigned int SpatialGrid::nextQueryMark()
+{
+	// on wrap-around, clear all marks so that stale ones cannot match
+	if (++_queryMark == 0)
+	{
+		for (auto& cell : _cells)
+			for (auto obj : cell)
+				obj->_queryMark = 0;
+		_queryMark = 1;
+	}
+	return _queryMark;
+}
+
+void SpatialGrid::query(const RectF& r, std::vector<Object*>& result)
+{
+	unsigned int mark = nextQueryMark();
+
+	RectI cells = cellRange(r);
+	for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+		for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+			for (auto obj : _cells[y * _cols + x])
+				if (obj->_queryMark != mark)
+				{
+					obj->_queryMark = mark;
+					result.push_back(obj);
+				}
+
+	result.insert(result.end(), _oversized.begin(), _oversized.end());
+}
+
+void SpatialGrid::query(const PointF& p, std::vector<Object*>& result)
+{
+	RectI cells = cellRange(RectF(p.x, p.y, 0, 0));
+	auto& cell = _cells[cells.pos.y * _cols + cells.pos.x];
+	result.insert(result.end(), cell.begin(), cell.end());
+	result.insert(result.end(), _oversized.begin(), _oversized.end());
+}
+
+bool SpatialGrid::raycast(const LineF& line, const CellVisitor& visitor)
+{
+	// objects outside the grid are clamped to the border cells, hence
+	// cells order is meaningful only for lines within the grid
+	RectF lineRect = line.boundingRect(_rect.yUp);
+	if (lineRect.pos.x < _rect.pos.x || lineRect.pos.y < _rect.pos.y ||
+		lineRect.pos.x + lineRect.size.x > _rect.pos.x + _rect.size.x ||
+		lineRect.pos.y + lineRect.size.y > _rect.pos.y + _rect.size.y)
+		return false;
+
+	unsigned int mark = nextQueryMark();
+
+	// Amanatides-Woo traversal
+	PointF d = line.end - line.start;
+	RectI cell = cellRange(RectF(line.start.x, line.start.y, 0, 0));
+	int x = cell.pos.x;
+	int y = cell.pos.y;
+	int stepX = d.x > 0 ? 1 : (d.x < 0 ? -1 : 0);
+	int stepY = d.y > 0 ? 1 : (d.y < 0 ? -1 : 0);
+	float tDeltaX = stepX ? _cellSize / std::abs(d.x) : INFINITY;
+	float tDeltaY = stepY ? _cellSize / std::abs(d.y) : INFINITY;
+	float tMaxX = stepX ? (_rect.pos.x + (x + (stepX > 0 ? 1 : 0)) * _cellSize - line.start.x) / d.x : INFINITY;
+	float tMaxY = stepY ? (_rect.pos.y + (y + (stepY > 0 ? 1 : 0)) * _cellSize - line.start.y) / d.y : INFINITY;
+
+	_rayBuffer.assign(_oversized.begin(), _oversized.end());
+	float tEnter = 0;
+	while (true)
+	{
+		float tExit = std::min(std::min(tMaxX, tMaxY), 1.0f);
+
+		for (auto obj : _cells[y * _cols + x])
+			if (obj->_queryMark != mark)
+			{
+				obj->_queryMark = mark;
+				_rayBuffer.push_back(obj);
+			}
+		if (!visitor(_rayBuffer, tEnter, tExit))
+			break;
+		_rayBuffer.clear();
+
+		if (tExit >= 1)
+			break;
+
+		// step to the next cell along the nearest boundary
+		if (tMaxX < tMaxY)
+		{
+			x += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			y += stepY;
+			tMaxY += tDeltaY;
+		}
+		if (x < 0 || x >= _cols || y < 0 || y >= _rows)
+			break;
+		tEnter = tExit;
+	}
+
+	return true;
+}
@@ -0,0 +1,82 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <functional>
+#include "geometryUtils.h"
+
+namespace agp
+{
+	class Object;
+	class SpatialGrid;
+}
+
+// SpatialGrid class
+// - uniform grid partitioning of a rect (typically the scene rect)
+// - each object is binned into all the cells its rect overlaps
+//   (rects outside the grid are clamped to the border cells)
+// - oversized objects (e.g. backgrounds) are kept in a separate list
+//   instead of being replicated in hundreds of cells
+// - incremental update: an object is re-binned only if its cell range changes
+// - queries return each object at most once (query marks, NOT thread-safe)
+// - raycasts walk the cells crossed by the ray in order (DDA)
+class agp::SpatialGrid
+{
+	public:
+
+		// receives the objects met for the first time in the current cell and
+		// the ray parameters at which the cell is entered/exited
+		// returns false to stop the traversal
+		typedef std::function<bool(const std::vector<Object*>& objects, float tEnter, float tExit)> CellVisitor;
+
+	protected:
+
+		RectF _rect;							// gridded area
+		float _cellSize;						// cell size in scene units
+		int _cols, _rows;						// number of cells along x and y
+		int _maxCellsPerObject;					// above this, object is oversized
+		std::vector< std::vector<Object*> > _cells;	// row-major cells
+		std::vector< Object*> _oversized;		// objects spanning too many cells
+		unsigned int _queryMark;				// current query mark
+		std::vector< Object*> _rayBuffer;		// reused by raycast
+
+		// helper functions
+		RectI cellRange(const RectF& r) const;
+		void insertCells(Object* obj, const RectI& cells);
+		void removeCells(Object* obj, const RectI& cells);
+		unsigned int nextQueryMark();
+
+	public:
+
+		SpatialGrid(const RectF& rect = RectF(), float cellSize = 4, int maxCellsPerObject = 64);
+
+		// getters
+		const RectF& rect() const { return _rect; }
+		float cellSize() const { return _cellSize; }
+
+		// resets grid geometry (all objects are removed)
+		void reset(const RectF& rect, float cellSize);
+
+		// add/remove/update objects
+		void add(Object* obj);
+		void remove(Object* obj);
+		void update(Object* obj);
+		void clear();
+
+		// appends objects whose cells overlap the given rect / point
+		// (candidates only: exact geometric test is up to the caller)
+		void query(const RectF& r, std::vector<Object*>& result);
+		void query(const PointF& p, std::vector<Object*>& result);
+
+		// visits the cells crossed by the line in ray order (oversized objects
+		// are visited with the first cell), starting from the line start
+		// returns false (and visits nothing) if the line is not within the grid
+		bool raycast(const LineF& line, const CellVisitor& visitor);
+};
@@ -17,7 +17,8 @@ Sprite::Sprite(SDL_Texture* spritesheet, const RectI& rect)
 	_spritesheet = spritesheet;
 	_rect = rect;
 
-	if (!_rect.isValid())
+	// no spritesheet (headless): frame metadata only
+	if (!_rect.isValid() && spritesheet)
 		SDL_QueryTexture(spritesheet, nullptr, nullptr, &_rect.size.x, &_rect.size.y);
 }
 
@@ -30,7 +31,20 @@ void Sprite::render(
 	SDL_RendererFlip flip,
 	bool fit)
 {
-	SDL_Rect srcRect = _rect.toSDL();
+	blit(_rect, renderer, drawRect, camera, pixelUnitSize, angle, flip, fit);
+}
+
+void Sprite::blit(
+	const RectI& frame,
+	SDL_Renderer* renderer,
+	const RectF& drawRect,
+	Transform camera,
+	const Point& pixelUnitSize,
+	float angle,
+	SDL_RendererFlip flip,
+	bool fit)
+{
+	SDL_Rect srcRect = frame.toSDL();
 	SDL_FRect drawRect_sdl;
 
 	// expand
@@ -38,13 +52,13 @@ void Sprite::render(
 	{
 		// correct aspect ratio
 		RectF correctedDrawRectAR = drawRect;
-		correctedDrawRectAR.size.y = drawRect.size.x / _rect.aspectRatio();
+		correctedDrawRectAR.size.y = drawRect.size.x / frame.aspectRatio();
 
 		// correct scale mismatch (might be due to previous AR correction) 
 		RectF pixelRect(0, 0, 1.0f / pixelUnitSize.x, 1.0f / pixelUnitSize.y);
 		RectF scaledPixelRect(camera(pixelRect.tl()), camera(pixelRect.br()));
 		RectF scaledCorrectedDrawRectAR(camera(correctedDrawRectAR.tl()), camera(correctedDrawRectAR.br()));
-		Vec2Df scaleCorrection = (scaledCorrectedDrawRectAR.size / _rect.size) / scaledPixelRect.size;
+		Vec2Df scaleCorrection = (scaledCorrectedDrawRectAR.size / frame.size) / scaledPixelRect.size;
 		scaledCorrectedDrawRectAR.size /= scaleCorrection;
 
 		// correct position
@@ -24,6 +24,17 @@ class agp::Sprite
 
 		SDL_Texture* _spritesheet;		// spritesheet texture
 		RectI _rect;					// in spritesheets coordinates
+
+		// blits the given spritesheet rect
+		void blit(
+			const RectI& frame,
+			SDL_Renderer* renderer,
+			const RectF& drawRect,
+			Transform camera,
+			const Point& pixelUnitSize,
+			float angle,
+			SDL_RendererFlip flip,
+			bool fit);
 		
 	public:
 
@@ -43,6 +54,22 @@ class agp::Sprite
 			SDL_RendererFlip flip = SDL_FLIP_NONE,
 			bool fit = true);			// fit within drawRect or expand
 
+		// render method for a given frame (e.g. captured by a render snapshot)
+		// - sprites made of frames blit the given spritesheet rect
+		// - the others (tiled, filled, text) ignore it and render as usual
+		virtual void renderFrame(
+			const RectI& frame,
+			SDL_Renderer* renderer,
+			const RectF& drawRect,
+			Transform camera,
+			const Point& pixelUnitSize,
+			float angle = 0,
+			SDL_RendererFlip flip = SDL_FLIP_NONE,
+			bool fit = true)
+		{
+			blit(frame, renderer, drawRect, camera, pixelUnitSize, angle, flip, fit);
+		}
+
 		// update method (for logic, animations)
 		virtual void update(float dt) {};
 
@@ -0,0 +1,181 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "SweepAndPrune.h"
+#include "Object.h"
+
+using namespace agp;
+
+void SweepAndPrune::add(Object* obj)
+{
+	if (obj->_broadphaseIndex >= 0)
+		return;
+
+	// appended as inactive: it is sorted in place at the next update
+	obj->_broadphaseIndex = int(_proxies.size());
+	_proxies.push_back({ obj, RectF(), false, false, 0, 0 });
+}
+
+void SweepAndPrune::remove(Object* obj)
+{
+	int index = obj->_broadphaseIndex;
+	if (index < 0)
+		return;
+
+	// erase (instead of swap-and-pop) preserves sort order
+	_proxies.erase(_proxies.begin() + index);
+	for (int i = index; i < int(_proxies.size()); i++)
+		_proxies[i].obj->_broadphaseIndex = i;
+	obj->_broadphaseIndex = -1;
+
+	// pairs may refer to the removed object: invalid until next update
+	_pairs.clear();
+	_adjStart.clear();
+	_adjacency.clear();
+}
+
+void SweepAndPrune::clear()
+{
+	for (auto& proxy : _proxies)
+		proxy.obj->_broadphaseIndex = -1;
+	_proxies.clear();
+	_pairs.clear();
+	_adjStart.clear();
+	_adjacency.clear();
+}
+
+void SweepAndPrune::update(float dt, const CollisionMatrix& matrix)
+{
+	for (auto& proxy : _proxies)
+	{
+		proxy.category = proxy.obj->collisionCategory();
+		proxy.mask = matrix.filter(proxy.obj);
+		proxy.sleeping = !proxy.obj->_awake && !proxy.obj->_alwaysAwake;
+		proxy.active = (proxy.category || proxy.mask) && proxy.obj->broadphaseBounds(proxy.sleeping ? 0 : dt, proxy.bounds);
+	}
+
+	sort();
+	sweep();
+	buildAdjacency();
+}
+
+void SweepAndPrune::sort()
+{
+	// insertion sort: nearly linear on the almost sorted order of the previous step
+	// ties are broken by id so that the order (and the pairs) is deterministic
+	for (int i = 1; i < int(_proxies.size()); i++)
+	{
+		Proxy key = _proxies[i];
+		int j = i - 1;
+		while (j >= 0 && (_proxies[j].bounds.pos.x > key.bounds.pos.x ||
+			(_proxies[j].bounds.pos.x == key.bounds.pos.x && _proxies[j].obj->id() > key.obj->id())))
+		{
+			_proxies[j + 1] = _proxies[j];
+			j--;
+		}
+		_proxies[j + 1] = key;
+	}
+
+	for (int i = 0; i < int(_proxies.size()); i++)
+		_proxies[i].obj->_broadphaseIndex = i;
+}
+
+void SweepAndPrune::sweep()
+{
+	_pairs.clear();
+
+	int n = int(_proxies.size());
+	for (int i = 0; i < n; i++)
+	{
+		const Proxy& pi = _proxies[i];
+		if (!pi.active)
+			continue;
+
+		float maxX = pi.bounds.pos.x + pi.bounds.size.x;
+		for (int j = i + 1; j < n && _proxies[j].bounds.pos.x <= maxX; j++)
+		{
+			const Proxy& pj = _proxies[j];
+			if (!pj.active || (pi.sleeping && pj.sleeping) || !((pi.mask & pj.category) || (pj.mask & pi.category)))
+				continue;
+
+			// x overlap is guaranteed by the sweep, test y (inclusive)
+			if (pi.bounds.pos.y <= pj.bounds.pos.y + pj.bounds.size.y &&
+				pj.bounds.pos.y <= pi.bounds.pos.y + pi.bounds.size.y)
+			{
+				if (pi.obj->id() < pj.obj->id())
+					_pairs.push_back({ pi.obj, pj.obj, false });
+				else
+					_pairs.push_back({ pj.obj, pi.obj, false });
+			}
+		}
+	}
+}
+
+void SweepAndPrune::buildAdjacency()
+{
+	// counting sort of pair endpoints by proxy index
+	int n = int(_proxies.size());
+	_adjStart.assign(n + 1, 0);
+	for (auto& pair : _pairs)
+	{
+		_adjStart[pair.a->_broadphaseIndex + 1]++;
+		_adjStart[pair.b->_broadphaseIndex + 1]++;
+	}
+	for (int i = 0; i < n; i++)
+		_adjStart[i + 1] += _adjStart[i];
+
+	_adjacency.resize(_adjStart[n]);
+	_adjFill.assign(_adjStart.begin(), _adjStart.end() - 1);
+	for (int p = 0; p < int(_pairs.size()); p++)
+	{
+		_adjacency[_adjFill[_pairs[p].a->_broadphaseIndex]++] = p;
+		_adjacency[_adjFill[_pairs[p].b->_broadphaseIndex]++] = p;
+	}
+}
+
+bool SweepAndPrune::contains(Object* obj) const
+{
+	int index = obj->_broadphaseIndex;
+	return index >= 0 && index < int(_proxies.size()) && _proxies[index].active && !_proxies[index].sleeping;
+}
+
+bool SweepAndPrune::candidates(Object* obj, std::vector<Object*>& result) const
+{
+	if (!contains(obj) || _adjStart.size() != _proxies.size() + 1)
+		return false;
+
+	int index = obj->_broadphaseIndex;
+	for (int k = _adjStart[index]; k < _adjStart[index + 1]; k++)
+	{
+		const Pair& pair = _pairs[_adjacency[k]];
+		result.push_back(pair.a == obj ? pair.b : pair.a);
+	}
+
+	return true;
+}
+
+bool SweepAndPrune::firstContact(Object* a, Object* b)
+{
+	int index = a->_broadphaseIndex;
+	if (index < 0 || index + 1 >= int(_adjStart.size()))
+		return true;
+
+	for (int k = _adjStart[index]; k < _adjStart[index + 1]; k++)
+	{
+		Pair& pair = _pairs[_adjacency[k]];
+		if (pair.a == b || pair.b == b)
+		{
+			bool first = !pair.notified;
+			pair.notified = true;
+			return first;
+		}
+	}
+
+	return true;
+}
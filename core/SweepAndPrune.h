@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include "geometryUtils.h"
+#include "CollisionMatrix.h"
+
+namespace agp
+{
+	class Object;
+	class SweepAndPrune;
+}
+
+// SweepAndPrune class
+// - collision broadphase over moving objects
+// - once per step, asks each object its (fat) bounds for the step
+//   (see Object::broadphaseBounds) and sorts them along x
+// - sorting is incremental (insertion sort on the previous order):
+//   objects move a little between steps, hence almost linear
+// - sweeping the sorted bounds yields each candidate pair exactly once
+// - pairs are created only if at least one object tests the other
+//   (collision categories/masks and matrix); objects colliding with
+//   no category and having no category are skipped altogether
+// - pairs are also indexed per object (compact adjacency arrays)
+// - keeps track of which pairs already had their logic collision
+//   in the current step, so that it is notified once per pair
+// - sleeping objects (see GameScene activation) are static: bounds
+//   without motion, no pairs among them and no candidates of their own
+class agp::SweepAndPrune
+{
+	public:
+
+		struct Pair
+		{
+			Object* a;			// object with lowest id
+			Object* b;			// object with highest id
+			bool notified;		// logic collision already notified in this step
+		};
+
+	protected:
+
+		struct Proxy
+		{
+			Object* obj;
+			RectF bounds;		// fat bounds in the current step
+			bool active;		// if false, not taking part in the current step
+			bool sleeping;		// if true, static in the current step (see update)
+			CollisionMask category;	// collision category bit(s)
+			CollisionMask mask;		// categories tested by the object (matrix applied)
+		};
+
+		std::vector<Proxy> _proxies;	// sorted by ascending bounds min x
+		std::vector<Pair> _pairs;		// candidate pairs of the current step
+		std::vector<int> _adjStart;		// per proxy: first entry in _adjacency
+		std::vector<int> _adjacency;	// per proxy: indices of its pairs
+		std::vector<int> _adjFill;		// scratch buffer for adjacency build
+
+		// helper functions
+		void sort();
+		void sweep();
+		void buildAdjacency();
+
+	public:
+
+		SweepAndPrune() {}
+
+		// add/remove objects
+		void add(Object* obj);
+		void remove(Object* obj);
+		void clear();
+
+		// recomputes bounds, sort order and candidate pairs for the next step
+		void update(float dt, const CollisionMatrix& matrix);
+
+		// getters
+		const std::vector<Pair>& pairs() const { return _pairs; }
+
+		// whether the object takes part in the current step (and is awake)
+		bool contains(Object* obj) const;
+
+		// appends candidate partners of the given object
+		// returns false if the object does not take part in the current step
+		bool candidates(Object* obj, std::vector<Object*>& result) const;
+
+		// returns true only the first time it is called for a pair in the current step
+		// (always true for objects not paired by the broadphase)
+		bool firstContact(Object* a, Object* b);
+};
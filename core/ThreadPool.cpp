@@ -0,0 +1,225 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+using namespace agp;
+
+// pool and queue of the current thread (workers only)
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local int currentQueue = 0;
+
+int ThreadPool::TaskGraph::add(const Job& job, std::initializer_list<int> dependencies)
+{
+	int id = int(_tasks.size());
+	_tasks.emplace_back();
+	Task& task = _tasks.back();
+	task.job = job;
+	task.dependencies = 0;
+	task.pending = nullptr;
+	for (int dep : dependencies)
+		if (dep >= 0 && dep < id)
+		{
+			_tasks[dep].successors.push_back(&task);
+			task.dependencies++;
+		}
+
+	return id;
+}
+
+ThreadPool::ThreadPool(int threads)
+{
+	_queued = 0;
+	_quit = false;
+	setThreads(threads);
+}
+
+ThreadPool::~ThreadPool()
+{
+	stop();
+}
+
+void ThreadPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (auto& worker : _workers)
+		worker.join();
+	_workers.clear();
+	_quit = false;
+}
+
+void ThreadPool::setThreads(int threads)
+{
+	stop();
+
+	threads = std::max(threads, 1);
+	_queues.clear();
+	for (int i = 0; i < threads; i++)
+		_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	for (int i = 1; i < threads; i++)
+		_workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+int ThreadPool::queueIndex() const
+{
+	return currentPool == this ? currentQueue : 0;
+}
+
+void ThreadPool::push(Task* task)
+{
+	Queue& queue = *_queues[queueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(task);
+	}
+	_queued++;
+
+	// under the lock: a worker about to sleep sees either the job or the notify
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+	}
+	_wake.notify_one();
+}
+
+ThreadPool::Task* ThreadPool::take(int index)
+{
+	// own queue first (newest job: cache-friendly, nested jobs finish first)
+	{
+		Queue& queue = *_queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty())
+		{
+			Task* task = queue.tasks.back();
+			queue.tasks.pop_back();
+			_queued--;
+			return task;
+		}
+	}
+
+	// steal the oldest job of another thread (largest remaining work)
+	int n = int(_queues.size());
+	for (int k = 1; k < n; k++)
+	{
+		Queue& queue = *_queues[(index + k) % n];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty())
+		{
+			Task* task = queue.tasks.front();
+			queue.tasks.pop_front();
+			_queued--;
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+void ThreadPool::execute(Task* task)
+{
+	task->job();
+
+	// successors become ready before this task is counted as done,
+	// so that waiters never see a run done with jobs still to start
+	std::atomic<int>* pending = task->pending;
+	for (auto successor : task->successors)
+		if (--successor->unfinished == 0)
+			push(successor);
+	(*pending)--;
+}
+
+void ThreadPool::wait(std::atomic<int>& pending)
+{
+	int index = queueIndex();
+	while (pending > 0)
+	{
+		Task* task = take(index);
+		if (task)
+			execute(task);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void ThreadPool::workerLoop(int index)
+{
+	currentPool = this;
+	currentQueue = index;
+
+	while (true)
+	{
+		Task* task = take(index);
+		if (task)
+		{
+			execute(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_wake.wait(lock, [this]() { return _quit || _queued > 0; });
+		if (_quit)
+			return;
+	}
+}
+
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)>& body)
+{
+	grain = std::max(grain, 1);
+	if (_workers.empty() || count <= grain)
+	{
+		if (count > 0)
+			body(0, count);
+		return;
+	}
+
+	// one job per chunk, on the stack until all are done
+	int chunks = (count + grain - 1) / grain;
+	std::atomic<int> pending(chunks);
+	std::vector<Task> tasks(chunks);
+	for (int c = 0; c < chunks; c++)
+	{
+		int begin = c * grain;
+		int end = std::min(begin + grain, count);
+		tasks[c].job = [&body, begin, end]() { body(begin, end); };
+		tasks[c].dependencies = 0;
+		tasks[c].pending = &pending;
+	}
+
+	// pushed in reverse: the caller runs the first chunks, thieves the last ones
+	for (int c = chunks - 1; c >= 0; c--)
+		push(&tasks[c]);
+
+	wait(pending);
+}
+
+void ThreadPool::run(TaskGraph& graph)
+{
+	if (_workers.empty())
+	{
+		for (auto& task : graph._tasks)
+			task.job();
+		return;
+	}
+
+	std::atomic<int> pending(graph.size());
+	for (auto& task : graph._tasks)
+	{
+		task.unfinished = task.dependencies;
+		task.pending = &pending;
+	}
+	for (auto& task : graph._tasks)
+		if (task.dependencies == 0)
+			push(&task);
+
+	wait(pending);
+}
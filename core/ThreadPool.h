@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+
+namespace agp
+{
+	class ThreadPool;
+}
+
+// ThreadPool class
+// - fixed set of worker threads running jobs (work-stealing): each thread
+//   has its own queue, takes its newest job first and, when empty, steals
+//   the oldest job of another thread; workers sleep when there is no job
+// - parallel loops and task graphs are blocking, and the calling thread
+//   runs jobs too while waiting (nested loops/graphs inside jobs are fine)
+// - task graphs: jobs with dependencies on earlier jobs (acyclic by
+//   construction), built once and run as many times as needed
+// - the split among threads is NOT deterministic: each job must only
+//   write its own data, or data no concurrent job reads
+class agp::ThreadPool
+{
+	public:
+
+		typedef std::function<void()> Job;
+
+	protected:
+
+		struct Task
+		{
+			Job job;
+			std::vector<Task*> successors;		// tasks depending on this one
+			int dependencies;					// tasks this one depends on
+			std::atomic<int> unfinished;		// dependencies still to run (current run)
+			std::atomic<int>* pending;			// tasks still to run of the current run
+		};
+
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Task*> tasks;			// owner: back, thieves: front
+		};
+
+		std::vector<std::thread> _workers;
+		std::vector<std::unique_ptr<Queue>> _queues;	// [0]: external threads, [i]: worker i
+		std::mutex _sleepMutex;
+		std::condition_variable _wake;			// workers: new jobs or quit
+		std::atomic<int> _queued;				// jobs in the queues
+		bool _quit;
+
+		// helper functions
+		int queueIndex() const;
+		void push(Task* task);
+		Task* take(int index);
+		void execute(Task* task);
+		void wait(std::atomic<int>& pending);
+		void workerLoop(int index);
+		void stop();
+
+	public:
+
+		// TaskGraph class
+		// - jobs with dependencies, run by ThreadPool::run
+		// - a job runs after all its dependencies are done
+		class TaskGraph
+		{
+			friend class ThreadPool;
+
+			protected:
+
+				std::deque<Task> _tasks;		// stable addresses
+
+			public:
+
+				// adds a job depending on the given (earlier) jobs, returns its id
+				int add(const Job& job, std::initializer_list<int> dependencies = {});
+
+				int size() const { return int(_tasks.size()); }
+				void clear() { _tasks.clear(); }
+		};
+
+		// threads: total number of threads, calling thread included (1 = serial)
+		ThreadPool(int threads = 1);
+		~ThreadPool();
+
+		// getters/setters
+		int threads() const { return int(_workers.size()) + 1; }
+		void setThreads(int threads);
+
+		// runs body(begin, end) on chunks of [0, count) of at most grain iterations
+		// and returns when all iterations are done
+		void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+		// runs all jobs of the graph and returns when all are done
+		// (serial: in insertion order)
+		void run(TaskGraph& graph);
+};
@@ -0,0 +1,225 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "TileGrid.h"
+#include "SDL.h"
+#include "SDL_image.h"
+#include "collisionUtils.h"
+
+using namespace agp;
+
+TileGrid::TileGrid()
+{
+	_tileSize = 1;
+	_cols = _rows = 0;
+}
+
+void TileGrid::reset(const PointF& origin, float tileSize, int cols, int rows)
+{
+	_origin = origin;
+	_tileSize = tileSize;
+	_cols = std::max(cols, 0);
+	_rows = std::max(rows, 0);
+	_solid.assign(_cols * _rows, false);
+}
+
+void TileGrid::load(const std::vector<int>& tiles, int cols, const PointF& origin, float tileSize)
+{
+	int rows = cols > 0 ? int(tiles.size()) / cols : 0;
+	reset(origin, tileSize, cols, rows);
+	for (int i = 0; i < _cols * _rows; i++)
+		_solid[i] = tiles[i] != 0;
+}
+
+bool TileGrid::loadBitmap(const std::string& filepath, int tilePixels, const std::vector<Material>& solidMaterials,
+	const PointF& origin, float tileSize)
+{
+	SDL_Surface* loaded = IMG_Load(filepath.c_str());
+	if (!loaded)
+	{
+		std::cerr << "Cannot load level bitmap " << filepath << ": " << SDL_GetError() << "\n";
+		return false;
+	}
+
+	// fixed byte order (R, G, B, A) whatever the file format
+	SDL_Surface* surf = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loaded);
+	if (!surf)
+	{
+		std::cerr << "Cannot convert level bitmap " << filepath << ": " << SDL_GetError() << "\n";
+		return false;
+	}
+
+	reset(origin, tileSize, surf->w / tilePixels, surf->h / tilePixels);
+
+	SDL_LockSurface(surf);
+	const unsigned char* pixels = static_cast<const unsigned char*>(surf->pixels);
+	int tileArea = tilePixels * tilePixels;
+	std::vector<int> counts;		// per material color, pixels of the current tile
+	for (int row = 0; row < _rows; row++)
+		for (int col = 0; col < _cols; col++)
+			for (auto& material : solidMaterials)
+			{
+				counts.assign(material.colors.size(), 0);
+				for (int y = row * tilePixels; y < (row + 1) * tilePixels; y++)
+				{
+					const unsigned char* p = pixels + y * surf->pitch + col * tilePixels * 4;
+					for (int x = 0; x < tilePixels; x++, p += 4)
+						for (size_t k = 0; k < material.colors.size(); k++)
+							if (p[0] == material.colors[k].r && p[1] == material.colors[k].g && p[2] == material.colors[k].b)
+							{
+								counts[k]++;
+								break;
+							}
+				}
+
+				int count = 0;
+				bool shares = true;
+				for (int c : counts)
+				{
+					count += c;
+					shares = shares && c >= int(std::ceil(material.minShare * tileArea));
+				}
+				if (shares && count >= int(std::ceil(material.coverage * tileArea)))
+				{
+					_solid[row * _cols + col] = true;
+					break;
+				}
+			}
+	SDL_UnlockSurface(surf);
+	SDL_FreeSurface(surf);
+
+	return true;
+}
+
+RectI TileGrid::tileRange(const RectF& r) const
+{
+	// clamping in the float domain (robust to huge/infinite rects)
+	float x0 = std::max(std::floor((r.pos.x - _origin.x) / _tileSize), 0.0f);
+	float y0 = std::max(std::floor((r.pos.y - _origin.y) / _tileSize), 0.0f);
+	float x1 = std::min(std::floor((r.pos.x + r.size.x - _origin.x) / _tileSize), float(_cols - 1));
+	float y1 = std::min(std::floor((r.pos.y + r.size.y - _origin.y) / _tileSize), float(_rows - 1));
+	if (x1 < x0 || y1 < y0)
+		return RectI(0, 0, 0, 0);
+
+	return RectI(int(x0), int(y0), int(x1 - x0) + 1, int(y1 - y0) + 1);
+}
+
+bool TileGrid::internalFace(int col, int row, const Vec2Df& normal) const
+{
+	int dx = normal.x > 0 ? 1 : (normal.x < 0 ? -1 : 0);
+	int dy = normal.y > 0 ? 1 : (normal.y < 0 ? -1 : 0);
+	return (dx || dy) && solid(col + dx, row + dy);
+}
+
+bool TileGrid::overlaps(const RectF& r) const
+{
+	RectI range = tileRange(r);
+	for (int row = range.pos.y; row < range.pos.y + range.size.y; row++)
+		for (int col = range.pos.x; col < range.pos.x + range.size.x; col++)
+			if (_solid[row * _cols + col] && r.intersects(tileRect(col, row)))
+				return true;
+
+	return false;
+}
+
+bool TileGrid::overlap(const RectF& r, Vec2Df& axis, float& depth) const
+{
+	// deepest contact through a face exposed to the rect
+	// (deepest internal one only if the rect is embedded)
+	bool exposed = false;
+	bool intersects = false;
+	RectI range = tileRange(r);
+	for (int row = range.pos.y; row < range.pos.y + range.size.y; row++)
+		for (int col = range.pos.x; col < range.pos.x + range.size.x; col++)
+		{
+			Direction dir;
+			float tileDepth;
+			if (!_solid[row * _cols + col] || !checkCollisionAABB(r, tileRect(col, row), dir, tileDepth))
+				continue;
+
+			Vec2Df tileAxis = dir2vec(dir);
+			bool tileExposed = !internalFace(col, row, -tileAxis);
+			if (!intersects || (tileExposed && !exposed) || (tileExposed == exposed && tileDepth > depth))
+			{
+				axis = tileAxis;
+				depth = tileDepth;
+				exposed = tileExposed;
+				intersects = true;
+			}
+		}
+
+	return intersects;
+}
+
+bool TileGrid::sweptRect(const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time) const
+{
+	time = INFINITY;
+	RectI range = tileRange(source.united(source + sweep));
+	for (int row = range.pos.y; row < range.pos.y + range.size.y; row++)
+		for (int col = range.pos.x; col < range.pos.x + range.size.x; col++)
+		{
+			if (!_solid[row * _cols + col])
+				continue;
+
+			Vec2Df cp, cn;
+			float t;
+			if (DynamicRectVsRect(source, sweep, tileRect(col, row), cp, cn, t) && t < time &&
+				!internalFace(col, row, cn))
+			{
+				time = t;
+				normal = cn;
+			}
+		}
+
+	return time != INFINITY;
+}
+
+bool TileGrid::raycast(const LineF& line, float& tNear) const
+{
+	// Amanatides-Woo traversal (tiles outside the grid are empty)
+	PointF d = line.end - line.start;
+	int x = int(std::floor((line.start.x - _origin.x) / _tileSize));
+	int y = int(std::floor((line.start.y - _origin.y) / _tileSize));
+	int stepX = d.x > 0 ? 1 : (d.x < 0 ? -1 : 0);
+	int stepY = d.y > 0 ? 1 : (d.y < 0 ? -1 : 0);
+	float tDeltaX = stepX ? _tileSize / std::abs(d.x) : INFINITY;
+	float tDeltaY = stepY ? _tileSize / std::abs(d.y) : INFINITY;
+	float tMaxX = stepX ? (_origin.x + (x + (stepX > 0 ? 1 : 0)) * _tileSize - line.start.x) / d.x : INFINITY;
+	float tMaxY = stepY ? (_origin.y + (y + (stepY > 0 ? 1 : 0)) * _tileSize - line.start.y) / d.y : INFINITY;
+
+	float tEnter = 0;
+	while (tEnter <= 1)
+	{
+		if (solid(x, y))
+		{
+			tNear = tEnter;
+			return true;
+		}
+
+		// step to the next tile along the nearest boundary
+		if (tMaxX < tMaxY)
+		{
+			x += stepX;
+			tEnter = tMaxX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			y += stepY;
+			tEnter = tMaxY;
+			tMaxY += tDeltaY;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <string>
+#include "geometryUtils.h"
+#include "graphicsUtils.h"
+
+namespace agp
+{
+	class TileGrid;
+}
+
+// TileGrid class
+// - compact solid/empty grid of square tiles (one bit per tile),
+//   row-major from the top-left tile at origin
+// - loaded from a tile array or from a level bitmap (a tile is solid
+//   if enough of its pixels have the colors of a solid material)
+// - collision queries look up the tiles covered by the query rect directly:
+//   cost depends on the query size only, not on the level size
+// - tiles outside the grid are empty
+// - faces shared by two solid tiles are internal and never collide
+//   (no ghost contacts when sliding across tiles)
+class agp::TileGrid
+{
+	public:
+
+		// solid material of level bitmaps (e.g. ground, blocks, pipes)
+		// - a tile is made of it if at least coverage of its pixels have its
+		//   colors, each covering at least minShare of the tile (the latter
+		//   tells apart materials sharing colors, e.g. pipes from bushes)
+		struct Material
+		{
+			std::vector<Color> colors;
+			float coverage;
+			float minShare;
+		};
+
+	protected:
+
+		PointF _origin;				// scene position of the top-left tile corner
+		float _tileSize;			// tile size in scene units
+		int _cols, _rows;			// number of tiles along x and y
+		std::vector<bool> _solid;	// row-major, one bit per tile
+
+		// whether the face of the given solid tile along normal is shared with a solid tile
+		bool internalFace(int col, int row, const Vec2Df& normal) const;
+
+	public:
+
+		TileGrid();
+
+		// getters
+		int cols() const { return _cols; }
+		int rows() const { return _rows; }
+		float tileSize() const { return _tileSize; }
+		RectF rect() const { return RectF(_origin.x, _origin.y, _cols * _tileSize, _rows * _tileSize); }
+		RectF tileRect(int col, int row) const { return RectF(_origin.x + col * _tileSize, _origin.y + row * _tileSize, _tileSize, _tileSize); }
+
+		// tiles overlapping the given scene rect (clamped to the grid, may be empty)
+		RectI tileRange(const RectF& r) const;
+
+		// resets grid geometry (all tiles are empty)
+		void reset(const PointF& origin, float tileSize, int cols, int rows);
+
+		// tile access
+		bool solid(int col, int row) const { return col >= 0 && col < _cols && row >= 0 && row < _rows && _solid[row * _cols + col]; }
+		void setSolid(int col, int row, bool on) { if (col >= 0 && col < _cols && row >= 0 && row < _rows) _solid[row * _cols + col] = on; }
+
+		// loads a row-major tile array (0 = empty, any other value = solid)
+		void load(const std::vector<int>& tiles, int cols, const PointF& origin, float tileSize);
+
+		// loads a level bitmap made of tilePixels x tilePixels tiles
+		// - a tile is solid if it is made of any of the given materials
+		// - returns false if the bitmap cannot be loaded
+		bool loadBitmap(const std::string& filepath, int tilePixels, const std::vector<Material>& solidMaterials,
+			const PointF& origin, float tileSize);
+
+		// whether any solid tile overlaps the given rect
+		bool overlaps(const RectF& r) const;
+
+		// deepest overlap between rect and solid tiles (axis goes from rect to tiles)
+		bool overlap(const RectF& r, Vec2Df& axis, float& depth) const;
+
+		// swept rect vs. solid tiles: earliest contact along sweep
+		// (normal points to the rect, time in [0,1])
+		bool sweptRect(const RectF& source, const Vec2Df& sweep, Vec2Df& normal, float& time) const;
+
+		// first solid tile crossed by the line (DDA), tNear along the line
+		bool raycast(const LineF& line, float& tNear) const;
+};
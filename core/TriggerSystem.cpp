@@ -0,0 +1,223 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include "TriggerSystem.h"
+#include "Object.h"
+
+using namespace agp;
+
+TriggerSystem::TriggerSystem(const RectF& rect, float cellSize)
+{
+	_queryMark = 0;
+	_dispatching = false;
+	_cols = _rows = 0;
+	_cellSize = cellSize;
+	reset(rect, cellSize);
+}
+
+void TriggerSystem::reset(const RectF& rect, float cellSize)
+{
+	_rect = rect;
+	_cellSize = cellSize;
+	_cols = std::max(1, int(std::ceil(_rect.size.x / _cellSize)));
+	_rows = std::max(1, int(std::ceil(_rect.size.y / _cellSize)));
+	_cells.clear();
+	_cells.resize(_cols * _rows);
+
+	// re-bin volumes
+	for (int id = 0; id < int(_volumes.size()); id++)
+		if (_volumes[id].alive)
+		{
+			RectI cells = cellRange(_volumes[id].rect);
+			for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+				for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+					_cells[y * _cols + x].push_back(id);
+		}
+}
+
+RectI TriggerSystem::cellRange(const RectF& r) const
+{
+	// rects outside the grid are clamped to the border cells (see SpatialGrid)
+	float maxX = float(_cols - 1);
+	float maxY = float(_rows - 1);
+	int x0 = int(std::min(std::max(std::floor((r.pos.x - _rect.pos.x) / _cellSize), 0.0f), maxX));
+	int y0 = int(std::min(std::max(std::floor((r.pos.y - _rect.pos.y) / _cellSize), 0.0f), maxY));
+	int x1 = int(std::min(std::max(std::floor((r.pos.x + r.size.x - _rect.pos.x) / _cellSize), 0.0f), maxX));
+	int y1 = int(std::min(std::max(std::floor((r.pos.y + r.size.y - _rect.pos.y) / _cellSize), 0.0f), maxY));
+
+	return RectI(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+unsigned int TriggerSystem::nextQueryMark()
+{
+	// on wrap-around, clear all marks so that stale ones cannot match
+	if (++_queryMark == 0)
+	{
+		for (auto& volume : _volumes)
+			volume.queryMark = 0;
+		_queryMark = 1;
+	}
+	return _queryMark;
+}
+
+bool TriggerSystem::before(const Overlap& a, const Overlap& b)
+{
+	return a.volume != b.volume ? a.volume < b.volume : a.watcher->id() < b.watcher->id();
+}
+
+void TriggerSystem::erasePairs(int volume, Object* watcher)
+{
+	auto last = std::remove_if(_inside.begin(), _inside.end(),
+		[volume, watcher](const Overlap& o) { return o.volume == volume || o.watcher == watcher; });
+	_inside.erase(last, _inside.end());
+}
+
+int TriggerSystem::add(const RectF& rect, Handler handler, Object* watched)
+{
+	int id;
+	if (_freeIds.empty())
+	{
+		id = int(_volumes.size());
+		_volumes.push_back(Volume());
+	}
+	else
+	{
+		id = _freeIds.back();
+		_freeIds.pop_back();
+	}
+	_volumes[id] = { rect, watched, watched == nullptr, handler, true, 0 };
+
+	RectI cells = cellRange(rect);
+	for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+		for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+			_cells[y * _cols + x].push_back(id);
+
+	return id;
+}
+
+void TriggerSystem::remove(int id)
+{
+	if (id < 0 || id >= int(_volumes.size()) || !_volumes[id].alive)
+		return;
+
+	RectI cells = cellRange(_volumes[id].rect);
+	for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+		for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+		{
+			auto& cell = _cells[y * _cols + x];
+			cell.erase(std::find(cell.begin(), cell.end(), id));
+		}
+
+	_volumes[id].alive = false;
+	erasePairs(id, nullptr);
+
+	// the handler may be running (removal from a handler)
+	if (_dispatching)
+		_removedIds.push_back(id);
+	else
+		release(id);
+}
+
+void TriggerSystem::release(int id)
+{
+	// handler released now (it may own resources), not when the id is reused
+	_volumes[id].handler = nullptr;
+	_volumes[id].watched = nullptr;
+	_freeIds.push_back(id);
+}
+
+void TriggerSystem::watch(Object* obj)
+{
+	if (std::find(_watchers.begin(), _watchers.end(), obj) == _watchers.end())
+		_watchers.push_back(obj);
+}
+
+void TriggerSystem::unwatch(Object* obj)
+{
+	auto it = std::find(_watchers.begin(), _watchers.end(), obj);
+	if (it == _watchers.end())
+		return;
+
+	_watchers.erase(it);
+	erasePairs(-1, obj);
+
+	// volumes of this watcher only: no watcher at all from now on
+	for (auto& volume : _volumes)
+		if (volume.watched == obj)
+			volume.watched = nullptr;
+}
+
+void TriggerSystem::update()
+{
+	// overlaps of this update
+	_nextInside.clear();
+	for (auto watcher : _watchers)
+	{
+		const RectF& r = watcher->rect();
+		unsigned int mark = nextQueryMark();
+		RectI cells = cellRange(r);
+		for (int y = cells.pos.y; y < cells.pos.y + cells.size.y; y++)
+			for (int x = cells.pos.x; x < cells.pos.x + cells.size.x; x++)
+				for (int id : _cells[y * _cols + x])
+				{
+					Volume& volume = _volumes[id];
+					if (volume.queryMark == mark)
+						continue;
+					volume.queryMark = mark;
+					if ((volume.anyWatcher || volume.watched == watcher) && volume.rect.intersects(r))
+						_nextInside.push_back({ id, watcher, Event::STAY });
+				}
+	}
+	std::sort(_nextInside.begin(), _nextInside.end(), before);
+
+	// transitions: merge of the sorted overlaps of the previous and current update
+	_events.clear();
+	size_t i = 0, j = 0;
+	while (i < _inside.size() || j < _nextInside.size())
+	{
+		if (j == _nextInside.size() || (i < _inside.size() && before(_inside[i], _nextInside[j])))
+			_events.push_back({ _inside[i].volume, _inside[i++].watcher, Event::EXIT });
+		else if (i == _inside.size() || before(_nextInside[j], _inside[i]))
+			_events.push_back({ _nextInside[j].volume, _nextInside[j++].watcher, Event::ENTER });
+		else
+		{
+			_events.push_back({ _nextInside[j].volume, _nextInside[j].watcher, Event::STAY });
+			i++;
+			j++;
+		}
+	}
+	_inside.swap(_nextInside);
+
+	// dispatch (handlers may remove volumes/watchers of the next events)
+	_dispatching = true;
+	for (size_t e = 0; e < _events.size(); e++)
+	{
+		Overlap evt = _events[e];
+		Volume& volume = _volumes[evt.volume];
+		if (volume.alive && std::find(_watchers.begin(), _watchers.end(), evt.watcher) != _watchers.end())
+			volume.handler(evt.watcher, evt.event);
+	}
+	_dispatching = false;
+
+	for (int id : _removedIds)
+		release(id);
+	_removedIds.clear();
+}
+
+void TriggerSystem::clear()
+{
+	_volumes.clear();
+	_freeIds.clear();
+	_watchers.clear();
+	_inside.clear();
+	for (auto& cell : _cells)
+		cell.clear();
+}
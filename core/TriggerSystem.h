@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------
+// From "Algorithms and Game Programming" in C++ by Alessandro Bria
+// Copyright (C) 2024 Alessandro Bria (a.bria@unicas.it). 
+// All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <functional>
+#include "geometryUtils.h"
+
+namespace agp
+{
+	class Object;
+	class TriggerSystem;
+}
+
+// TriggerSystem class
+// - trigger volumes (scene rects) with their own uniform grid index,
+//   separate from scene objects: no physics, no collision candidates
+// - volumes are tested only against the registered watchers (e.g. player),
+//   using the watchers rects
+// - emits enter/exit events once per transition and stay events at every
+//   update while the watcher is inside, in volume then watcher creation order
+// - events are dispatched after all overlaps are computed: handlers may
+//   add/remove volumes and watchers
+class agp::TriggerSystem
+{
+	public:
+
+		enum class Event { ENTER, STAY, EXIT };
+		typedef std::function<void(Object* watcher, Event event)> Handler;
+
+	protected:
+
+		struct Volume
+		{
+			RectF rect;
+			Object* watched;		// the only watcher of the volume (if not anyWatcher)
+			bool anyWatcher;
+			Handler handler;
+			bool alive;				// false = removed (id can be reused)
+			unsigned int queryMark;	// last query that visited this volume
+		};
+
+		struct Overlap
+		{
+			int volume;
+			Object* watcher;
+			Event event;			// used by dispatch only
+		};
+
+		RectF _rect;							// gridded area
+		float _cellSize;						// cell size in scene units
+		int _cols, _rows;						// number of cells along x and y
+		std::vector< std::vector<int> > _cells;	// row-major cells of volume ids
+		std::deque<Volume> _volumes;			// by id (stable on insertion)
+		std::vector<int> _freeIds;				// removed volumes ids
+		std::vector<int> _removedIds;			// removed during dispatch (released after)
+		bool _dispatching;
+		std::vector<Object*> _watchers;
+		std::vector<Overlap> _inside;			// overlaps of the last update (sorted)
+		std::vector<Overlap> _nextInside;		// reused by update
+		std::vector<Overlap> _events;			// reused by update
+		unsigned int _queryMark;
+
+		// helper functions
+		RectI cellRange(const RectF& r) const;
+		unsigned int nextQueryMark();
+		static bool before(const Overlap& a, const Overlap& b);
+		void erasePairs(int volume, Object* watcher);
+		void release(int id);
+
+	public:
+
+		TriggerSystem(const RectF& rect = RectF(), float cellSize = 8);
+
+		// resets grid geometry (volumes are kept)
+		void reset(const RectF& rect, float cellSize);
+
+		// add/remove volumes (removal emits no exit events)
+		// watched: the only watcher the volume reacts to (null = any)
+		int add(const RectF& rect, Handler handler, Object* watched = nullptr);
+		void remove(int id);
+		int size() const { return int(_volumes.size() - _freeIds.size()); }
+
+		// add/remove watchers (removal emits no exit events)
+		void watch(Object* obj);
+		void unwatch(Object* obj);
+
+		// tests watchers against volumes and emits the events
+		void update();
+
+		// removes all volumes and watchers (not from handlers)
+		void clear();
+};
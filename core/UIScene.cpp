@@ -25,6 +25,6 @@ void UIScene::update(float timeToSimulate)
 
 	if (_active)
 		for (auto& layer : _sortedObjects)
-			for (auto& obj : layer.second)
+			for (auto& obj : layer.objects)
 				obj->update(timeToSimulate);
 }
\ No newline at end of file
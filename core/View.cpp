@@ -14,6 +14,9 @@
 #include "Scene.h"
 #include "Object.h"
 #include "RenderableObject.h"
+#include "RenderSnapshot.h"
+#include "Sprite.h"
+#include "sdlUtils.h"
 #include "timeUtils.h"
 
 using namespace agp;
@@ -84,22 +87,134 @@ void View::render()
 	SDL_RenderFillRect(renderer, &viewport_r);
 
 	// render objects
-	auto objects = _scene->objects(_rect);
-	for (auto& obj : objects)
+	// (moving objects drawn in their interpolated pos: the offset from their
+	// actual pos is passed with the camera, objects are left untouched)
+	float alpha = _scene->interpolationAlpha();
+	_scene->objects(_rect, _visibleObjects);
+	for (auto& obj : _visibleObjects)
 	{
 		RenderableObject* robj = obj->to<RenderableObject*>();
-		if (robj)
+		if (!robj)
+			continue;
+
+		if (alpha < 1 && obj->_prevPos != obj->_rect.pos)
+		{
+			Vec2Df offset = obj->interpolatedPos(alpha) - obj->_rect.pos;
+			robj->draw(renderer, [this, offset](const PointF& p) { return _scene2view(p + offset); });
+		}
+		else
 			robj->draw(renderer, _scene2view);
 	}
 }
 
-void View::updateViewport()
+void View::capture(RenderSnapshot& snapshot)
+{
+	snapshot.viewRect = _rect;
+	snapshot.viewStep = Vec2Df();
+	snapshot.viewport = _viewportAbs;
+	snapshot.clipRect = _clipRectAbs;
+	snapshot.magf = _magf;
+	snapshot.backgroundColor = _scene->backgroundColor();
+	snapshot.pixelUnitSize = _scene->pixelUnitSize();
+	snapshot.alpha = _scene->interpolationAlpha();
+	snapshot.dt = 0;
+	snapshot.time = std::chrono::steady_clock::now();
+
+	snapshot.items.clear();
+	_scene->objects(_rect, _visibleObjects);
+	for (auto& obj : _visibleObjects)
+	{
+		RenderableObject* robj = obj->to<RenderableObject*>();
+		if (robj)
+			robj->snapshot(snapshot);
+	}
+}
+
+void View::render(const RenderSnapshot& snapshot)
 {
 	SDL_Renderer* renderer = Game::instance()->window()->renderer();
 
+	// viewport clipping
+	SDL_Rect viewport_r = snapshot.viewport.toSDL();
+	SDL_Rect cliprect_r = snapshot.clipRect.toSDL();
+	if (snapshot.clipRect.isValid())
+		SDL_RenderSetClipRect(renderer, &cliprect_r);
+	else
+		SDL_RenderSetClipRect(renderer, &viewport_r);
+
+	// viewport background
+	const Color& bg = snapshot.backgroundColor;
+	SDL_SetRenderDrawColor(renderer, bg.r, bg.g, bg.b, bg.a);
+	SDL_RenderFillRect(renderer, &viewport_r);
+
+	// view (and items below) moved to the interpolated state
+	float alpha = snapshot.alphaAt(std::chrono::steady_clock::now());
+	RectF viewRect = snapshot.viewRect;
+	viewRect.pos += snapshot.viewStep * (alpha - snapshot.alpha);
+	PointF viewportPos = snapshot.viewport.pos;
+	PointF magf = snapshot.magf;
+	Transform scene2view = [viewRect, viewportPos, magf](const PointF& p)
+		{
+			if (viewRect.yUp)
+				return PointF(
+					viewportPos.x + (p.x - viewRect.pos.x) * magf.x,
+					viewportPos.y - (p.y - viewRect.pos.y - viewRect.size.y) * magf.y);
+			else
+				return PointF(
+					viewportPos.x + (p.x - viewRect.pos.x) * magf.x,
+					viewportPos.y + (p.y - viewRect.pos.y) * magf.y);
+		};
+
+	// render items
+	for (auto& item : snapshot.items)
+	{
+		Vec2Df offset = item.step * (alpha - 1);
+		RectF rect = item.rect + offset;
+		switch (item.kind)
+		{
+			case RenderSnapshot::Kind::FILL:
+			{
+				SDL_FRect drawRect = RectF(scene2view(rect.tl()), scene2view(rect.br())).toSDLf();
+				SDL_SetRenderDrawColor(renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+				SDL_RenderFillRectF(renderer, &drawRect);
+				break;
+			}
+			case RenderSnapshot::Kind::SPRITE:
+				item.sprite->renderFrame(item.frame, renderer, rect, scene2view, snapshot.pixelUnitSize, item.angle, item.flip, item.fit);
+				break;
+			case RenderSnapshot::Kind::RECT:
+			{
+				SDL_FRect drawRect = RectF(scene2view(rect.tl()), scene2view(rect.br())).toSDLf();
+				SDL_SetRenderDrawColor(renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+				if (item.thickness)
+					DrawThickRect(renderer, drawRect, item.thickness);
+				else
+					SDL_RenderDrawRectF(renderer, &drawRect);
+				break;
+			}
+			case RenderSnapshot::Kind::POLYGON:
+				DrawOBB(renderer, {
+					scene2view(item.vertices[0] + offset), scene2view(item.vertices[1] + offset),
+					scene2view(item.vertices[2] + offset), scene2view(item.vertices[3] + offset) }, item.color);
+				break;
+			case RenderSnapshot::Kind::LINE:
+			{
+				PointF a = scene2view(item.vertices[0] + offset);
+				PointF b = scene2view(item.vertices[1] + offset);
+				SDL_SetRenderDrawColor(renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+				SDL_RenderDrawLineF(renderer, a.x, a.y, b.x, b.y);
+				break;
+			}
+		}
+	}
+}
+
+void View::updateViewport()
+{
 	// get renderer size on screen
-	int rendWidth, rendHeight;
-	SDL_GetRendererOutputSize(renderer, &rendWidth, &rendHeight);
+	Point outputSize = Game::instance()->outputSize();
+	int rendWidth = outputSize.x;
+	int rendHeight = outputSize.y;
 
 	// update viewport absolute coordinates
 	_viewportAbs = RectF(
@@ -8,12 +8,15 @@
 // ----------------------------------------------------------------
 
 #pragma once
+#include <vector>
 #include "geometryUtils.h"
 
 namespace agp
 {
 	class Scene;
+	class Object;
 	class View;
+	class RenderSnapshot;
 }
 
 // View (or camera) class
@@ -21,6 +24,7 @@ namespace agp
 // - renders scene objects through a viewport
 // - only scene objects within the view's rect are drawn (culling)
 // - handles scene2view and view2scene transforms
+// - can also render a snapshot captured earlier (see RenderSnapshot)
 class agp::View
 {
 	private:
@@ -35,6 +39,7 @@ class agp::View
 		float _aspectRatio;			// fixed width/height aspect ratio (0 = not fixed)
 		RectF _clipRect;			// in relative [0,1] coords; if not set, _viewport is used
 		RectF _clipRectAbs;			// in absolute window coords
+		std::vector<Object*> _visibleObjects;	// reused at each render
 
 	public:
 
@@ -57,6 +62,11 @@ class agp::View
 		// render scene objects within view rect (culling)
 		void render();
 
+		// same as render, split in capture (simulation) and render of the
+		// captured snapshot (render thread, reads neither scene nor view)
+		void capture(RenderSnapshot& snapshot);
+		void render(const RenderSnapshot& snapshot);
+
 		// view transforms
 		void move(const Vec2Df& ds);
 		void move(float dx, float dy);
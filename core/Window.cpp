@@ -8,6 +8,7 @@
 // ----------------------------------------------------------------
 
 #include <algorithm>
+#include <iostream>
 #include "Window.h"
 #include "View.h"
 #include "Scene.h"
@@ -52,13 +53,47 @@ Window::~Window()
 	SDL_DestroyWindow(_window);
 }
 
-void Window::render(const std::vector<Scene*>& scenes)
+bool Window::vsync() const
+{
+	SDL_RendererInfo info;
+	return SDL_GetRendererInfo(_renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+}
+
+bool Window::setVSync(bool on)
+{
+	if (SDL_RenderSetVSync(_renderer, on ? 1 : 0))
+	{
+		std::cerr << "Cannot " << (on ? "enable" : "disable") << " vsync: " << SDL_GetError() << "\n";
+		return false;
+	}
+
+	return true;
+}
+
+int Window::refreshRate() const
+{
+	SDL_DisplayMode mode;
+	if (SDL_GetWindowDisplayMode(_window, &mode) == 0 && mode.refresh_rate > 0)
+		return mode.refresh_rate;
+
+	return 60;
+}
+
+void Window::render(const std::vector<Scene*>& scenes, std::mutex* scenesMutex)
 {
 	SDL_SetRenderDrawColor(_renderer, _color.r, _color.b, _color.g, 255);
 	SDL_RenderClear(_renderer);
 
-	for(auto scene : scenes)
-		scene->render();
+	for (auto scene : scenes)
+	{
+		if (scenesMutex && !scene->snapshotRendering())
+		{
+			std::lock_guard<std::mutex> lock(*scenesMutex);
+			scene->render();
+		}
+		else
+			scene->render();
+	}
 
 	SDL_RenderPresent(_renderer);
 }
\ No newline at end of file
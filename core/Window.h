@@ -10,6 +10,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <mutex>
 #include "SDL.h"
 #include "graphicsUtils.h"
 
@@ -41,6 +42,15 @@ class agp::Window
 		SDL_Renderer* renderer() { return _renderer; }
 		void setColor(const Color& c) { _color = c; }
 
+		// vertical sync of presents (false if not available)
+		bool vsync() const;
+		bool setVSync(bool on);
+
+		// refresh rate of the window display (60 if unknown)
+		int refreshRate() const;
+
 		// render on screen
-		void render(const std::vector<Scene*> & scenes);
+		// - scenesMutex: if given, scenes not rendered from snapshots are
+		//   rendered under this lock (simulation on another thread)
+		void render(const std::vector<Scene*> & scenes, std::mutex* scenesMutex = nullptr);
 };
\ No newline at end of file
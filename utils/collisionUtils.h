@@ -11,6 +11,12 @@
 
 #include "geometryUtils.h"
 #include "mathUtils.h"
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGP_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace agp
 {
@@ -56,7 +62,7 @@ namespace agp
 	}
 
 	// SAT Polygon vs. Polygon collision detection
-	// for better performance, replace std::vector with static std::array[MAX_DIM]
+	// for better performance with boxes, see the OrientedBox version below
 	static inline bool checkCollisionSAT(
 		const std::vector < Vec2Df >& polyA,
 		const std::vector < Vec2Df >& polyB,
@@ -98,24 +104,22 @@ namespace agp
 		// if intersects, compute collision direction and depth
 		if (intersects)
 		{
-			std::vector<Vec2Df> normals(polyA.size() + polyB.size());
 			Vec2Df centerA, centerB;
 			for (int i = 0; i < polyA.size(); i++)
-			{
-				normals[i] = (polyA[(i + 1) % polyA.size()] - polyA[i]).perp().norm(); //.norm() is necessary since we are measuring projections
 				centerA += polyA[i];
-			}
 			centerA /= float(polyA.size());
 			for (int i = 0; i < polyB.size(); i++)
-			{
-				normals[i + polyA.size()] = (polyB[(i + 1) % polyB.size()] - polyB[i]).perp().norm(); //.norm() is necessary since we are measuring projections
 				centerB += polyB[i];
-			}
 			centerB /= float(polyB.size());
 
+			// edge normals of both polygons (computed on the fly, no allocation)
 			collisionDepth = inf<float>();
-			for (auto& normal : normals)
+			for (int k = 0; k < polyA.size() + polyB.size(); k++)
 			{
+				const std::vector < Vec2Df >& poly = k < polyA.size() ? polyA : polyB;
+				int i = k < polyA.size() ? k : int(k - polyA.size());
+				Vec2Df normal = (poly[(i + 1) % poly.size()] - poly[i]).perp().norm(); //.norm() is necessary since we are measuring projections
+
 				float minA = inf<float>();
 				float maxA = -inf<float>();
 				for (auto& vertex : polyA)
@@ -150,6 +154,153 @@ namespace agp
 	}
 
 
+	// Oriented box (OBB) for allocation-free SAT tests
+	// - vertices and unit axes are computed once (e.g. when the collider
+	//   is defined) and reused by every test
+	// - opposite edges share the same axis, so 2 axes suffice
+	// - translation does not change axes (no trigonometry to move a box)
+	struct OrientedBox
+	{
+		Vec2Df center;
+		Vec2Df vertices[4];		// counterclockwise
+		Vec2Df axes[2];			// unit edge normals
+
+		OrientedBox() {}
+		OrientedBox(const RotatedRectF& r)
+		{
+			std::array<Vec2Df, 4> verts = r.vertices();
+			for (int i = 0; i < 4; i++)
+				vertices[i] = verts[i];
+			center = r.center;
+			axes[0] = (vertices[1] - vertices[0]).perp().norm();
+			axes[1] = (vertices[2] - vertices[1]).perp().norm();
+		}
+		OrientedBox(const LineF& segment)	// degenerate box (zero thickness)
+		{
+			vertices[0] = vertices[3] = segment.start;
+			vertices[1] = vertices[2] = segment.end;
+			center = (segment.start + segment.end) / 2;
+			axes[0] = (segment.end - segment.start).perp().norm();
+			axes[1] = (segment.end - segment.start).norm();
+		}
+		OrientedBox(const RectF& r)
+		{
+			std::array<Vec2Df, 4> verts = r.vertices();
+			for (int i = 0; i < 4; i++)
+				vertices[i] = verts[i];
+			center = r.center();
+			axes[0] = Vec2Df(1, 0);
+			axes[1] = Vec2Df(0, 1);
+		}
+
+		OrientedBox operator + (const Vec2Df& d) const
+		{
+			OrientedBox moved = *this;
+			moved.center += d;
+			for (int i = 0; i < 4; i++)
+				moved.vertices[i] += d;
+			return moved;
+		}
+
+		// projection interval on the given axis
+		inline void project(const Vec2Df& axis, float& minProj, float& maxProj) const
+		{
+			minProj = maxProj = vertices[0].dot(axis);
+			for (int i = 1; i < 4; i++)
+			{
+				float proj = vertices[i].dot(axis);
+				minProj = std::min(minProj, proj);
+				maxProj = std::max(maxProj, proj);
+			}
+		}
+	};
+
+	// SAT OBB vs. OBB collision detection (oriented boxes, 4 cached axes, no allocation)
+	// collisionAxis goes from A to B
+	static inline bool checkCollisionSAT(
+		const OrientedBox& obbA,
+		const OrientedBox& obbB,
+		Vec2Df& collisionAxis,
+		float& collisionDepth)
+	{
+		const Vec2Df* axes[4] = { &obbA.axes[0], &obbA.axes[1], &obbB.axes[0], &obbB.axes[1] };
+
+		collisionDepth = inf<float>();
+		for (int k = 0; k < 4; k++)
+		{
+			float minA, maxA, minB, maxB;
+			obbA.project(*axes[k], minA, maxA);
+			obbB.project(*axes[k], minB, maxB);
+			float axisDepth = std::min(maxB - minA, maxA - minB);
+			if (axisDepth <= 0)
+				return false;
+			if (axisDepth < collisionDepth)
+			{
+				collisionDepth = axisDepth;
+				collisionAxis = *axes[k];
+			}
+		}
+
+		// invert collisionAxis if not already going from A to B
+		if ((obbB.center - obbA.center).dot(collisionAxis) < 0)
+			collisionAxis = -collisionAxis;
+
+		return true;
+	}
+
+	// Swept (CCD) Dynamic OBB vs. OBB collision detection (SAT)
+	// - source moves by source_vel during the sweep, target does not move
+	// - contact time is the latest entry time among the 4 axes (each axis
+	//   gives the time interval in which projections overlap)
+	// - contact normal is the axis of latest entry, pointing to the source
+	//   (on ties, later axes win: vertical resolution for boxes as in DynamicRectVsRect)
+	static inline bool DynamicOBBVsOBB(
+		const OrientedBox& source,
+		const Vec2Df& source_vel,
+		const OrientedBox& target,
+		Vec2Df& contact_normal,
+		float& contact_time)
+	{
+		const Vec2Df* axes[4] = { &source.axes[0], &source.axes[1], &target.axes[0], &target.axes[1] };
+
+		float t_enter = -inf<float>();
+		float t_exit = inf<float>();
+		for (int k = 0; k < 4; k++)
+		{
+			const Vec2Df& axis = *axes[k];
+			float minA, maxA, minB, maxB;
+			source.project(axis, minA, maxA);
+			target.project(axis, minB, maxB);
+
+			// no motion along this axis: projections must already overlap (touching is not enough)
+			float v = source_vel.dot(axis);
+			if (v == 0)
+			{
+				if (maxA <= minB || maxB <= minA)
+					return false;
+				continue;
+			}
+
+			float t0 = (v > 0 ? minB - maxA : maxB - minA) / v;
+			float t1 = (v > 0 ? maxB - minA : minB - maxA) / v;
+			if (t0 >= t_enter)
+			{
+				t_enter = t0;
+				contact_normal = v > 0 ? -axis : axis;
+			}
+			t_exit = std::min(t_exit, t1);
+		}
+
+		// not moving towards the target, or overlap intervals do not intersect
+		if (t_enter == -inf<float>() || t_enter > t_exit || t_exit < 0)
+			return false;
+
+		// same tolerance of DynamicRectVsRect
+		float epsilon = 0.001f;
+		contact_time = t_enter;
+		return (contact_time >= 0 - epsilon && contact_time <= 1.0 + epsilon);
+	}
+
 	// Swept (CCD) Point vs. AABB collision detection
 	static inline bool PointVsRect(
 		const Vec2Df& p,
@@ -243,6 +394,141 @@ namespace agp
 			return false;
 	}
 
+	// structure-of-arrays batch of target rects
+	struct RectsSoA
+	{
+		std::vector<float> x, y, w, h;
+
+		void clear() { x.clear(); y.clear(); w.clear(); h.clear(); }
+		void push_back(const RectF& r) { x.push_back(r.pos.x); y.push_back(r.pos.y); w.push_back(r.size.x); h.push_back(r.size.y); }
+		int size() const { return int(x.size()); }
+	};
+
+	// structure-of-arrays batch of swept contacts (one per target)
+	// time and normal are valid only if hit is set
+	struct SweptContactsSoA
+	{
+		std::vector<float> time, nx, ny;
+		std::vector<unsigned char> hit;
+
+		void resize(int n) { time.resize(n); nx.resize(n); ny.resize(n); hit.resize(n); }
+	};
+
+	// Swept (CCD) Dynamic AABB vs. N AABBs collision detection (batch version)
+	// - same results (bit by bit) of DynamicRectVsRect on each target,
+	//   contact points excluded
+	// - source terms and divisions are computed once, targets are tested
+	//   4 at a time with SSE2 (branchless), scalar fallback otherwise
+	// returns the number of targets hit
+	static inline int DynamicRectVsRects(
+		const RectF& source,
+		const Vec2Df& source_vel,
+		const RectsSoA& targets,
+		SweptContactsSoA& contacts)
+	{
+		int n = targets.size();
+		contacts.resize(n);
+
+		// same terms of DynamicRectVsRect / PointVsRect
+		Vec2Df half = source.size / 2;
+		Vec2Df p = source.pos + half;
+		Vec2Df inv_vel = 1.0 / source_vel;
+		float normal_x = inv_vel.x < 0 ? 1.0f : -1.0f;
+		float normal_y = inv_vel.y < 0 ? 1.0f : -1.0f;
+
+		// contact time range: upper bound is compared in double by DynamicRectVsRect,
+		// so take the largest float not above it
+		float epsilon = 0.001f;
+		float t_min = 0 - epsilon;
+		double t_max_exact = 1.0 + epsilon;
+		float t_max = float(t_max_exact);
+		if (double(t_max) > t_max_exact)
+			t_max = std::nextafter(t_max, 0.0f);
+
+		const float* tx = targets.x.data();
+		const float* ty = targets.y.data();
+		const float* tw = targets.w.data();
+		const float* th = targets.h.data();
+		int hits = 0;
+		int i = 0;
+
+#ifdef AGP_SSE2
+		// NOTE: min/max operands are swapped to match std::min/std::max on equal values
+		const __m128 half_x = _mm_set1_ps(half.x), half_y = _mm_set1_ps(half.y);
+		const __m128 size_x = _mm_set1_ps(source.size.x), size_y = _mm_set1_ps(source.size.y);
+		const __m128 p_x = _mm_set1_ps(p.x), p_y = _mm_set1_ps(p.y);
+		const __m128 inv_x = _mm_set1_ps(inv_vel.x), inv_y = _mm_set1_ps(inv_vel.y);
+		const __m128 n_x = _mm_set1_ps(normal_x), n_y = _mm_set1_ps(normal_y);
+		const __m128 t_lo = _mm_set1_ps(t_min), t_hi = _mm_set1_ps(t_max), zero = _mm_setzero_ps();
+		for (; i + 4 <= n; i += 4)
+		{
+			// expanded target
+			__m128 ex = _mm_sub_ps(_mm_loadu_ps(tx + i), half_x);
+			__m128 ey = _mm_sub_ps(_mm_loadu_ps(ty + i), half_y);
+			__m128 ew = _mm_add_ps(_mm_loadu_ps(tw + i), size_x);
+			__m128 eh = _mm_add_ps(_mm_loadu_ps(th + i), size_y);
+
+			// intersections with rectangle bounding axes
+			__m128 t_near_x = _mm_mul_ps(_mm_sub_ps(ex, p_x), inv_x);
+			__m128 t_near_y = _mm_mul_ps(_mm_sub_ps(ey, p_y), inv_y);
+			__m128 t_far_x = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(ex, ew), p_x), inv_x);
+			__m128 t_far_y = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(ey, eh), p_y), inv_y);
+			__m128 ok = _mm_and_ps(_mm_cmpord_ps(t_near_x, t_far_x), _mm_cmpord_ps(t_near_y, t_far_y));
+
+			// swap distances if necessary
+			__m128 near_x = _mm_min_ps(t_far_x, t_near_x);
+			__m128 far_x = _mm_max_ps(t_near_x, t_far_x);
+			__m128 near_y = _mm_min_ps(t_far_y, t_near_y);
+			__m128 far_y = _mm_max_ps(t_near_y, t_far_y);
+
+			// early rejection, contact time, exit time and time range
+			ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmple_ps(near_x, far_y), _mm_cmple_ps(near_y, far_x)));
+			__m128 t_hit_near = _mm_max_ps(near_y, near_x);
+			__m128 t_hit_far = _mm_min_ps(far_y, far_x);
+			ok = _mm_and_ps(ok, _mm_cmpge_ps(t_hit_far, zero));
+			ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpge_ps(t_hit_near, t_lo), _mm_cmple_ps(t_hit_near, t_hi)));
+
+			// contact normal (diagonal collisions are resolved along y)
+			__m128 x_axis = _mm_cmpgt_ps(near_x, near_y);
+			_mm_storeu_ps(contacts.time.data() + i, t_hit_near);
+			_mm_storeu_ps(contacts.nx.data() + i, _mm_and_ps(x_axis, n_x));
+			_mm_storeu_ps(contacts.ny.data() + i, _mm_andnot_ps(x_axis, n_y));
+
+			int mask = _mm_movemask_ps(ok);
+			for (int k = 0; k < 4; k++)
+			{
+				contacts.hit[i + k] = (mask >> k) & 1;
+				hits += (mask >> k) & 1;
+			}
+		}
+#endif
+
+		// scalar fallback / remainder
+		for (; i < n; i++)
+		{
+			float ex = tx[i] - half.x;
+			float ey = ty[i] - half.y;
+			float t_near_x = (ex - p.x) * inv_vel.x;
+			float t_near_y = (ey - p.y) * inv_vel.y;
+			float t_far_x = (ex + (tw[i] + source.size.x) - p.x) * inv_vel.x;
+			float t_far_y = (ey + (th[i] + source.size.y) - p.y) * inv_vel.y;
+			bool ok = !std::isnan(t_near_x) && !std::isnan(t_near_y) && !std::isnan(t_far_x) && !std::isnan(t_far_y);
+			if (t_near_x > t_far_x) std::swap(t_near_x, t_far_x);
+			if (t_near_y > t_far_y) std::swap(t_near_y, t_far_y);
+			ok = ok && !(t_near_x > t_far_y || t_near_y > t_far_x);
+			float t_hit_near = std::max(t_near_x, t_near_y);
+			ok = ok && std::min(t_far_x, t_far_y) >= 0 && t_hit_near >= t_min && t_hit_near <= t_max;
+
+			contacts.time[i] = t_hit_near;
+			contacts.nx[i] = t_near_x > t_near_y ? normal_x : 0.0f;
+			contacts.ny[i] = t_near_x > t_near_y ? 0.0f : normal_y;
+			contacts.hit[i] = ok;
+			hits += ok;
+		}
+
+		return hits;
+	}
+
 	// Swept (CCD) Point vs. Line collision detection
 	static inline bool PointVsLine(
 		const Vec2Df& p,
@@ -290,13 +576,19 @@ namespace agp
 		return true;
 	}
 
+	// Swept (CCD) moving Line vs. Line collision detection
+	// contact normal always points to lineA's side (opposite to velA)
+	// hit_case: which endpoint hit the other line first
+	// - 0/1: lineA start/end hit lineB (contact point on lineB)
+	// - 2/3: lineB start/end hit lineA (contact point on lineA)
 	static inline bool DynamicLineVsLine(
 		LineF lineA,
 		Vec2Df velA,
 		LineF lineB,
 		Vec2Df& contact_point,
 		Vec2Df& contact_normal,
-		float& t_hit)
+		float& t_hit,
+		int& hit_case)
 	{
 		Vec2Df cps[4];
 		Vec2Df cns[4];
@@ -306,6 +598,8 @@ namespace agp
 		insersections[1] = PointVsLine(lineA.end,    velA, lineB, cps[1], cns[1], ts[1]);
 		insersections[2] = PointVsLine(lineB.start, -velA, lineA, cps[2], cns[2], ts[2]);
 		insersections[3] = PointVsLine(lineB.end,   -velA, lineA, cps[3], cns[3], ts[3]);
+		cns[2] = -cns[2];	// lineB endpoints move (-velA) against lineA: normals point to lineB
+		cns[3] = -cns[3];
 		t_hit = std::numeric_limits<float>::infinity();
 		for(int i=0; i<4; i++)
 			if (insersections[i] && ts[i] < t_hit)
@@ -313,7 +607,19 @@ namespace agp
 				t_hit = ts[i];
 				contact_point = cps[i];
 				contact_normal = cns[i];
+				hit_case = i;
 			}
 		return t_hit != std::numeric_limits<float>::infinity();
 	}
+	static inline bool DynamicLineVsLine(
+		LineF lineA,
+		Vec2Df velA,
+		LineF lineB,
+		Vec2Df& contact_point,
+		Vec2Df& contact_normal,
+		float& t_hit)
+	{
+		int hit_case;
+		return DynamicLineVsLine(lineA, velA, lineB, contact_point, contact_normal, t_hit, hit_case);
+	}
 }
\ No newline at end of file
@@ -179,7 +179,7 @@ namespace agp
         SDL_RenderGeometry(renderer, nullptr, &SDL_vertices[0], 6, &SDL_indices[0], 6);
     }
 
-    // load image from file into texture
+    // load image from file into texture (no renderer: nullptr)
     static inline SDL_Texture* loadTexture(
         SDL_Renderer* renderer,
         const std::string& filepath,
@@ -194,6 +194,13 @@ namespace agp
         if (mask.a)
             SDL_SetColorKey(surf, SDL_TRUE, SDL_MapRGB(surf->format, mask.r, mask.g, mask.b));
 
+        // no renderer (headless): no texture
+        if (!renderer)
+        {
+            SDL_FreeSurface(surf);
+            return nullptr;
+        }
+
         // create texture from surf
         SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
         SDL_FreeSurface(surf);
@@ -313,6 +320,7 @@ namespace agp
     }
 
     // load image from file into texture and detect rects row-wise automatically
+    // (no renderer: rects only, nullptr)
     static inline SDL_Texture* loadTextureAutoDetect(
         SDL_Renderer* renderer,
         const std::string& filepath,
@@ -508,6 +516,13 @@ namespace agp
 
         SDL_SetColorKey(surf, SDL_TRUE, spriteMaskPixelValue);
 
+        // No renderer (headless): detected rects only
+        if (!renderer)
+        {
+            SDL_FreeSurface(surf);
+            return nullptr;
+        }
+
         // Create texture from surface
         SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
         SDL_FreeSurface(surf);
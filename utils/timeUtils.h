@@ -13,6 +13,7 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include <thread>
 #include <iostream>
 
 namespace agp
@@ -89,6 +90,108 @@ namespace agp
 			}
 	};
 
+	// frame deltas averaged over the last frames (OS scheduling jitter)
+	// and clamped (long stalls, e.g. window dragging)
+	class FrameSmoother
+	{
+		private:
+
+			std::vector<float> _history;
+			int _next;
+			int _count;
+			float _sum;
+			float _maxDelta;
+
+		public:
+
+			FrameSmoother(int frames = 8, float maxDelta = 0.25f)
+			{
+				_maxDelta = maxDelta;
+				setFrames(frames);
+			}
+
+			int frames() const { return int(_history.size()); }
+			void setFrames(int frames)
+			{
+				_history.assign(frames > 1 ? frames : 1, 0.0f);
+				_next = 0;
+				_count = 0;
+				_sum = 0;
+			}
+
+			// returns the smoothed delta (1 frame = raw delta, clamped)
+			inline float smooth(float delta)
+			{
+				delta = delta < 0 ? 0 : (delta > _maxDelta ? _maxDelta : delta);
+				_sum += delta - _history[_next];
+				_history[_next] = delta;
+				_next = (_next + 1) % int(_history.size());
+				if (_count < int(_history.size()))
+					_count++;
+
+				// running sum recomputed once per round (no float drift)
+				if (_next == 0)
+				{
+					_sum = 0;
+					for (float d : _history)
+						_sum += d;
+				}
+
+				return _sum / _count;
+			}
+	};
+
+	// waits for the next frame deadline of a fixed frame rate: sleeps for
+	// most of the wait, then spins for the last part (the spin margin
+	// adapts to the sleep overshoot measured on this system)
+	class FrameLimiter
+	{
+		private:
+
+			std::chrono::steady_clock::time_point _next;
+			double _spinMargin;		// seconds
+
+		public:
+
+			FrameLimiter() { reset(); }
+
+			double spinMargin() const { return _spinMargin; }
+
+			void reset()
+			{
+				_next = std::chrono::steady_clock::now();
+				_spinMargin = 0.002;
+			}
+
+			inline void wait(double frameTime)
+			{
+				typedef std::chrono::steady_clock clock;
+				_next += std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(frameTime));
+
+				// late (e.g. slow frame): no burst of frames to catch up
+				clock::time_point now = clock::now();
+				if (_next <= now)
+				{
+					_next = now;
+					return;
+				}
+
+				clock::time_point wakeUp = _next - std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(_spinMargin));
+				if (wakeUp > now)
+				{
+					std::this_thread::sleep_until(wakeUp);
+
+					// margin follows the worst recent overshoot (up fast, down slowly)
+					double overshoot = std::chrono::duration<double>(clock::now() - wakeUp).count();
+					_spinMargin = overshoot * 1.25 > _spinMargin * 0.99 ? overshoot * 1.25 : _spinMargin * 0.99;
+					_spinMargin = _spinMargin < 0.0002 ? 0.0002 : (_spinMargin > 0.004 ? 0.004 : _spinMargin);
+				}
+
+				while (clock::now() < _next)
+					std::this_thread::yield();
+			}
+	};
+
 	class Profiler
 	{
 		private: